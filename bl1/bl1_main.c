@@ -13,6 +13,9 @@
 #include <console.h>
 #include <debug.h>
 #include <errata_report.h>
+#if TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA
+#include <mbedtls_common.h>
+#endif
 #include <platform.h>
 #include <platform_def.h>
 #include <smccc_helpers.h>
@@ -154,6 +157,11 @@ void bl1_main(void)
 
 	bl1_prepare_next_image(image_id);
 
+#if TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA
+	/* Report the mbed TLS heap usage of this boot stage */
+	mbedtls_heap_print_stats();
+#endif
+
 	console_flush();
 }
 
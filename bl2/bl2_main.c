@@ -11,6 +11,9 @@
 #include <bl_common.h>
 #include <console.h>
 #include <debug.h>
+#if TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA
+#include <mbedtls_common.h>
+#endif
 #include <platform.h>
 #include "bl2_private.h"
 
@@ -46,6 +49,11 @@ void bl2_main(void)
 	/* Load the subsequent bootloader images. */
 	next_bl_ep_info = bl2_load_images();
 
+#if TRUSTED_BOARD_BOOT && TF_MBEDTLS_HEAP_ARENA
+	/* Report the mbed TLS heap usage of this boot stage */
+	mbedtls_heap_print_stats();
+#endif
+
 #if !BL2_AT_EL3
 #ifdef AARCH32
 	/*
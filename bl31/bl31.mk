@@ -22,6 +22,7 @@ BL31_SOURCES		+=	bl31/bl31_main.c				\
 				bl31/aarch64/ea_delegate.S			\
 				bl31/aarch64/runtime_exceptions.S		\
 				bl31/bl31_context_mgmt.c			\
+				bl31/bl31_ns_mem.c				\
 				common/runtime_svc.c				\
 				lib/aarch64/setjmp.S				\
 				plat/common/aarch64/platform_mp_stack.S		\
@@ -39,6 +40,20 @@ ifeq (${EL3_EXCEPTION_HANDLING},1)
 BL31_SOURCES		+=	bl31/ehf.c
 endif
 
+ifeq (${CONSOLE_LOG_RING},1)
+BL31_SOURCES		+=	common/tf_log_ring.c
+endif
+
+ifeq (${BINARY_LOG},1)
+BL31_SOURCES		+=	common/tf_log_binary.c
+endif
+
+ifeq (${SDEI_STATS},1)
+ifeq (${SDEI_SUPPORT},0)
+  $(error SDEI_SUPPORT must be 1 for SDEI_STATS)
+endif
+endif
+
 ifeq (${SDEI_SUPPORT},1)
 ifeq (${EL3_EXCEPTION_HANDLING},0)
   $(error EL3_EXCEPTION_HANDLING must be 1 for SDEI support)
@@ -48,6 +63,9 @@ BL31_SOURCES		+=	services/std_svc/sdei/sdei_dispatch.S	\
 				services/std_svc/sdei/sdei_intr_mgmt.c	\
 				services/std_svc/sdei/sdei_main.c	\
 				services/std_svc/sdei/sdei_state.c
+ifeq (${SDEI_STATS},1)
+BL31_SOURCES		+=	services/std_svc/sdei/sdei_stats.c
+endif
 endif
 
 ifeq (${ENABLE_SPE_FOR_LOWER_ELS},1)
@@ -63,6 +81,10 @@ ifeq (${ENABLE_SVE_FOR_NS},1)
 BL31_SOURCES		+=	lib/extensions/sve/sve.c
 endif
 
+ifeq (${CTX_LAZY_FPREGS},1)
+BL31_SOURCES		+=	lib/el3_runtime/aarch64/lazy_fpregs.c
+endif
+
 ifeq (${WORKAROUND_CVE_2017_5715},1)
 BL31_SOURCES		+=	lib/cpus/aarch64/wa_cve_2017_5715_bpiall.S	\
 				lib/cpus/aarch64/wa_cve_2017_5715_mmu.S
@@ -79,7 +101,9 @@ endif
 $(eval $(call assert_boolean,CRASH_REPORTING))
 $(eval $(call assert_boolean,EL3_EXCEPTION_HANDLING))
 $(eval $(call assert_boolean,SDEI_SUPPORT))
+$(eval $(call assert_boolean,SDEI_STATS))
 
 $(eval $(call add_define,CRASH_REPORTING))
 $(eval $(call add_define,EL3_EXCEPTION_HANDLING))
 $(eval $(call add_define,SDEI_SUPPORT))
+$(eval $(call add_define,SDEI_STATS))
@@ -72,6 +72,10 @@ void bl31_lib_init(void)
  ******************************************************************************/
 void bl31_main(void)
 {
+#if BINARY_LOG
+	tf_log_binary_init();
+#endif
+
 	NOTICE("BL31: %s\n", version_string);
 	NOTICE("BL31: %s\n", build_message);
 
@@ -120,6 +124,11 @@ void bl31_main(void)
 	 * from BL31
 	 */
 	bl31_plat_runtime_setup();
+
+#if CONSOLE_LOG_RING
+	/* From now on, buffer the console output of the CPUs */
+	tf_log_ring_enable();
+#endif
 }
 
 /*******************************************************************************
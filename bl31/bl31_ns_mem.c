@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <bl31.h>
+#include <errno.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+
+#if PLAT_XLAT_TABLES_DYNAMIC
+#include <xlat_tables_v2.h>
+
+/*
+ * Serialises the changes to the dynamic regions of the EL3 translation tables
+ * made at runtime on behalf of the Normal world, and the accesses to Non-secure
+ * memory through regions that another cpu may remove.
+ */
+static spinlock_t bl31_ns_mem_lock;
+
+void bl31_ns_mem_lock_acquire(void)
+{
+	spin_lock(&bl31_ns_mem_lock);
+}
+
+void bl31_ns_mem_lock_release(void)
+{
+	spin_unlock(&bl31_ns_mem_lock);
+}
+
+/*******************************************************************************
+ * Map the Non-secure memory at [base, base + size) into EL3 as writable,
+ * non-executable memory, with VA == PA. The range is rejected with -EINVAL
+ * unless the platform confirms it is Non-secure memory. Otherwise, returns the
+ * result of mmap_add_dynamic_region(). Must be called with the lock held.
+ ******************************************************************************/
+int bl31_map_ns_mem(uintptr_t base, size_t size)
+{
+	if (plat_is_ns_mem(base, size) == 0)
+		return -EINVAL;
+
+	return mmap_add_dynamic_region(base, base, size,
+			MT_MEMORY | MT_RW | MT_NS | MT_EXECUTE_NEVER);
+}
+
+/*******************************************************************************
+ * Unmap a region mapped by bl31_map_ns_mem(). Must be called with the lock
+ * held.
+ ******************************************************************************/
+int bl31_unmap_ns_mem(uintptr_t base, size_t size)
+{
+	return mmap_remove_dynamic_region(base, size);
+}
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
@@ -183,45 +183,104 @@ static void dump_load_info(uintptr_t image_load_addr,
 }
 #endif /* LOAD_IMAGE_V2 */
 
-/* Generic function to return the size of an image */
-size_t get_image_size(unsigned int image_id)
+/*
+ * Sources of the images resolved by the platform during this boot stage, so
+ * that each image is located only once. Direct mapped by image ID.
+ */
+#define IMAGE_SOURCES		16U
+
+typedef struct image_source {
+	unsigned int	image_id;
+	uintptr_t	dev_handle;
+	uintptr_t	image_spec;
+} image_source_t;
+
+static image_source_t image_sources[IMAGE_SOURCES];
+
+/* Forget the image sources, e.g. when the platform changes of boot source */
+static void forget_image_sources(void)
 {
-	uintptr_t dev_handle;
-	uintptr_t image_handle;
-	uintptr_t image_spec;
-	size_t image_size = 0;
+	zeromem(image_sources, sizeof(image_sources));
+}
+
+static int get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			    uintptr_t *image_spec)
+{
+	image_source_t *source = &image_sources[image_id % IMAGE_SOURCES];
 	int io_result;
 
+	if ((source->dev_handle != (uintptr_t)NULL) &&
+	    (source->image_id == image_id)) {
+		*dev_handle = source->dev_handle;
+		*image_spec = source->image_spec;
+		return 0;
+	}
+
 	/* Obtain a reference to the image by querying the platform layer */
-	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
+	io_result = plat_get_image_source(image_id, dev_handle, image_spec);
 	if (io_result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
 			image_id, io_result);
-		return 0;
+		return io_result;
 	}
 
+	source->image_id = image_id;
+	source->dev_handle = *dev_handle;
+	source->image_spec = *image_spec;
+
+	return 0;
+}
+
+/*
+ * Open an image and return its handle and size. The device connections are
+ * kept open for the rest of the boot stage.
+ */
+static int open_image(unsigned int image_id, uintptr_t *image_handle,
+		      size_t *image_size)
+{
+	uintptr_t dev_handle;
+	uintptr_t image_spec;
+	int io_result;
+
+	io_result = get_image_source(image_id, &dev_handle, &image_spec);
+	if (io_result != 0)
+		return io_result;
+
 	/* Attempt to access the image */
-	io_result = io_open(dev_handle, image_spec, &image_handle);
+	io_result = io_open(dev_handle, image_spec, image_handle);
 	if (io_result != 0) {
 		WARN("Failed to access image id=%u (%i)\n",
 			image_id, io_result);
-		return 0;
+		/* Ask the platform again next time */
+		image_sources[image_id % IMAGE_SOURCES].dev_handle =
+			(uintptr_t)NULL;
+		return io_result;
 	}
 
 	/* Find the size of the image */
-	io_result = io_size(image_handle, &image_size);
-	if ((io_result != 0) || (image_size == 0)) {
+	io_result = io_size(*image_handle, image_size);
+	if ((io_result != 0) || (*image_size == 0)) {
 		WARN("Failed to determine the size of the image id=%u (%i)\n",
 			image_id, io_result);
+		io_close(*image_handle);
+		/* Ignore improbable/unrecoverable error in 'close' */
+		return (io_result != 0) ? io_result : -EIO;
 	}
-	io_result = io_close(image_handle);
-	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this
-	 * bootloader stage
-	 */
-	io_result = io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
+	return 0;
+}
+
+/* Generic function to return the size of an image */
+size_t get_image_size(unsigned int image_id)
+{
+	uintptr_t image_handle;
+	size_t image_size;
+
+	if (open_image(image_id, &image_handle, &image_size) != 0)
+		return 0;
+
+	io_close(image_handle);
+	/* Ignore improbable/unrecoverable error in 'close' */
 
 	return image_size;
 }
@@ -238,9 +297,7 @@ size_t get_image_size(unsigned int image_id)
  ******************************************************************************/
 static int load_image(unsigned int image_id, image_info_t *image_data)
 {
-	uintptr_t dev_handle;
 	uintptr_t image_handle;
-	uintptr_t image_spec;
 	uintptr_t image_base;
 	size_t image_size;
 	size_t bytes_read;
@@ -251,33 +308,13 @@ static int load_image(unsigned int image_id, image_info_t *image_data)
 
 	image_base = image_data->image_base;
 
-	/* Obtain a reference to the image by querying the platform layer */
-	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
-	if (io_result != 0) {
-		WARN("Failed to obtain reference to image id=%u (%i)\n",
-			image_id, io_result);
+	io_result = open_image(image_id, &image_handle, &image_size);
+	if (io_result != 0)
 		return io_result;
-	}
-
-	/* Attempt to access the image */
-	io_result = io_open(dev_handle, image_spec, &image_handle);
-	if (io_result != 0) {
-		WARN("Failed to access image id=%u (%i)\n",
-			image_id, io_result);
-		return io_result;
-	}
 
 	INFO("Loading image id=%u at address %p\n", image_id,
 		(void *) image_base);
 
-	/* Find the size of the image */
-	io_result = io_size(image_handle, &image_size);
-	if ((io_result != 0) || (image_size == 0)) {
-		WARN("Failed to determine the size of the image id=%u (%i)\n",
-			image_id, io_result);
-		goto exit;
-	}
-
 	/* Check that the image size to load is within limit */
 	if (image_size > image_data->image_max_size) {
 		WARN("Image id=%u size out of bounds\n", image_id);
@@ -302,10 +339,6 @@ exit:
 	io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this bootloader stage */
-	io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
-
 	return io_result;
 }
 
@@ -381,6 +414,8 @@ int load_auth_image(unsigned int image_id, image_info_t *image_data)
 
 	do {
 		err = load_auth_image_internal(image_id, image_data, 0);
+		if (err != 0)
+			forget_image_sources();
 	} while (err != 0 && plat_try_next_boot_source());
 
 	return err;
@@ -411,9 +446,7 @@ int load_image(meminfo_t *mem_layout,
 	       image_info_t *image_data,
 	       entry_point_info_t *entry_point_info)
 {
-	uintptr_t dev_handle;
 	uintptr_t image_handle;
-	uintptr_t image_spec;
 	size_t image_size;
 	size_t bytes_read;
 	int io_result;
@@ -422,33 +455,13 @@ int load_image(meminfo_t *mem_layout,
 	assert(image_data != NULL);
 	assert(image_data->h.version == VERSION_1);
 
-	/* Obtain a reference to the image by querying the platform layer */
-	io_result = plat_get_image_source(image_id, &dev_handle, &image_spec);
-	if (io_result != 0) {
-		WARN("Failed to obtain reference to image id=%u (%i)\n",
-			image_id, io_result);
-		return io_result;
-	}
-
-	/* Attempt to access the image */
-	io_result = io_open(dev_handle, image_spec, &image_handle);
-	if (io_result != 0) {
-		WARN("Failed to access image id=%u (%i)\n",
-			image_id, io_result);
+	io_result = open_image(image_id, &image_handle, &image_size);
+	if (io_result != 0)
 		return io_result;
-	}
 
 	INFO("Loading image id=%u at address %p\n", image_id,
 		(void *) image_base);
 
-	/* Find the size of the image */
-	io_result = io_size(image_handle, &image_size);
-	if ((io_result != 0) || (image_size == 0)) {
-		WARN("Failed to determine the size of the image id=%u (%i)\n",
-			image_id, io_result);
-		goto exit;
-	}
-
 	/* Check that the memory where the image will be loaded is free */
 	if (!is_mem_free(mem_layout->free_base, mem_layout->free_size,
 			 image_base, image_size)) {
@@ -504,10 +517,6 @@ exit:
 	io_close(image_handle);
 	/* Ignore improbable/unrecoverable error in 'close' */
 
-	/* TODO: Consider maintaining open device connection from this bootloader stage */
-	io_dev_close(dev_handle);
-	/* Ignore improbable/unrecoverable error in 'dev_close' */
-
 	return io_result;
 }
 
@@ -587,6 +596,8 @@ int load_auth_image(meminfo_t *mem_layout,
 	do {
 		err = load_auth_image_internal(mem_layout, image_id, image_base,
 					       image_data, entry_point_info, 0);
+		if (err != 0)
+			forget_image_sources();
 	} while (err != 0 && plat_try_next_boot_source());
 
 	return err;
@@ -94,3 +94,722 @@ int fdtw_write_inplace_cells(void *dtb, int node, const char *prop,
 
 	return 0;
 }
+
+#define FDTW_INDEX_COMPATIBLE	1U
+#define FDTW_INDEX_PHANDLE	2U
+#define FDTW_INDEX_END		0xffffU
+
+/* FNV-1a hash of a string */
+static uint32_t fdtw_hash(const char *str, size_t len)
+{
+	uint32_t hash = 2166136261U;
+	size_t i;
+
+	for (i = 0; i < len; i++) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619U;
+	}
+	return hash;
+}
+
+/*
+ * Add an entry at the end of its hash chain, so that lookups find the first
+ * matching node in the order of the blob, like libfdt does.
+ */
+static int fdtw_index_add(fdtw_index_t *index, unsigned int type,
+		uint32_t key, int offset)
+{
+	fdtw_index_entry_t *entry;
+	uint16_t *link;
+
+	if (index->num_entries == index->max_entries)
+		return -1;
+
+	entry = &index->entries[index->num_entries];
+	entry->key = key;
+	entry->offset = offset;
+	entry->next = FDTW_INDEX_END;
+	entry->type = (uint16_t)type;
+
+	link = &index->buckets[key % FDTW_INDEX_BUCKETS];
+	while (*link != FDTW_INDEX_END)
+		link = &index->entries[*link].next;
+	*link = (uint16_t)index->num_entries++;
+
+	return 0;
+}
+
+/*
+ * Build the index of the nodes of 'dtb' by compatible string and by phandle, in
+ * a single pass over the blob. Entries are allocated in 'arena', one per
+ * compatible string and one per phandle. Returns 0 on success, and -1 if the
+ * blob is invalid or the arena is too small.
+ */
+int fdtw_index_init(fdtw_index_t *index, const void *dtb, void *arena,
+		size_t arena_size)
+{
+	const char *compat;
+	unsigned int i;
+	uint32_t phandle;
+	int node, len, str_len;
+
+	assert(index != NULL);
+	assert(dtb != NULL);
+	assert((arena != NULL) || (arena_size == 0U));
+	assert(((uintptr_t)arena % sizeof(uint32_t)) == 0U);
+
+	index->dtb = dtb;
+	index->entries = arena;
+	index->num_entries = 0;
+	index->max_entries = arena_size / sizeof(fdtw_index_entry_t);
+	if (index->max_entries > FDTW_INDEX_END)
+		index->max_entries = FDTW_INDEX_END;
+	for (i = 0; i < FDTW_INDEX_BUCKETS; i++)
+		index->buckets[i] = FDTW_INDEX_END;
+
+	if (fdt_check_header(dtb) != 0) {
+		WARN("Invalid DTB\n");
+		return -1;
+	}
+
+	for (node = fdt_next_node(dtb, -1, NULL); node >= 0;
+	     node = fdt_next_node(dtb, node, NULL)) {
+		compat = fdt_getprop(dtb, node, "compatible", &len);
+		while ((compat != NULL) && (len > 0)) {
+			str_len = (int)strnlen(compat, (size_t)len);
+			if (fdtw_index_add(index, FDTW_INDEX_COMPATIBLE,
+					fdtw_hash(compat, (size_t)str_len),
+					node) != 0)
+				goto full;
+			compat += str_len + 1;
+			len -= str_len + 1;
+		}
+
+		phandle = fdt_get_phandle(dtb, node);
+		if ((phandle != 0U) && (phandle != (uint32_t)-1)) {
+			if (fdtw_index_add(index, FDTW_INDEX_PHANDLE, phandle,
+					node) != 0)
+				goto full;
+		}
+	}
+
+	if (node != -FDT_ERR_NOTFOUND) {
+		WARN("Failed to parse DTB (%d)\n", node);
+		return -1;
+	}
+
+	return 0;
+
+full:
+	WARN("DTB index arena too small\n");
+	return -1;
+}
+
+/*
+ * Return the offset of the first node compatible with 'compatible', or
+ * -FDT_ERR_NOTFOUND. Equivalent to fdt_node_offset_by_compatible(dtb, -1,
+ * compatible).
+ */
+int fdtw_node_offset_by_compatible(const fdtw_index_t *index,
+		const char *compatible)
+{
+	const fdtw_index_entry_t *entry;
+	uint32_t key;
+	uint16_t i;
+
+	assert(index != NULL);
+	assert(compatible != NULL);
+
+	key = fdtw_hash(compatible, strlen(compatible));
+	for (i = index->buckets[key % FDTW_INDEX_BUCKETS];
+	     i != FDTW_INDEX_END; i = entry->next) {
+		entry = &index->entries[i];
+		if ((entry->type == FDTW_INDEX_COMPATIBLE) &&
+		    (entry->key == key) &&
+		    (fdt_node_check_compatible(index->dtb, entry->offset,
+					       compatible) == 0))
+			return entry->offset;
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+/*
+ * Return the offset of the node with the given phandle, or -FDT_ERR_NOTFOUND.
+ * Equivalent to fdt_node_offset_by_phandle().
+ */
+int fdtw_node_offset_by_phandle(const fdtw_index_t *index, uint32_t phandle)
+{
+	const fdtw_index_entry_t *entry;
+	uint16_t i;
+
+	assert(index != NULL);
+
+	for (i = index->buckets[phandle % FDTW_INDEX_BUCKETS];
+	     i != FDTW_INDEX_END; i = entry->next) {
+		entry = &index->entries[i];
+		if ((entry->type == FDTW_INDEX_PHANDLE) &&
+		    (entry->key == phandle))
+			return entry->offset;
+	}
+
+	return -FDT_ERR_NOTFOUND;
+}
+
+
+/*
+ * Batched edits
+ *
+ * Each fdt_setprop() or fdt_add_subnode() call which grows a blob moves
+ * everything that follows the edit, so a series of edits costs O(edits * size).
+ * fdtw_apply_edits() instead takes all the edits at once and writes the
+ * resulting blob in a single pass. The result is the same tree as if the edits
+ * had been applied in order with libfdt: new properties and subnodes are placed
+ * where libfdt would place them and new property names are appended to the
+ * strings block in the same order.
+ */
+
+#define FDTW_TAGALIGN(x)	(((x) + FDT_TAGSIZE - 1U) & ~(FDT_TAGSIZE - 1U))
+
+/* Maximum depth of the nodes of a blob edited by fdtw_apply_edits() */
+#define FDTW_EDIT_MAX_DEPTH	32
+
+typedef struct fdtw_edit_ctx {
+	uint8_t			*out_struct;
+	unsigned int		pos;
+	const uint8_t		*in_struct;
+	const fdtw_edit_t	*edits;
+	unsigned int		num_edits;
+} fdtw_edit_ctx_t;
+
+/* Whether 'edit' is the first of the edits of the batch on its property */
+static inline int fdtw_is_group_first(const fdtw_edit_t *edit)
+{
+	return (edit->op != FDTW_EDIT_ADD_SUBNODE) && (edit->group == edit->seq);
+}
+
+/*
+ * Find the offset of the name of a new property in the strings block, where
+ * libfdt would find it or add it. As with libfdt, a name may be found as the
+ * suffix of a longer string. 'edits' are the 'num' edits of the batch preceding
+ * the new property and '*new_size' the size of the names they added.
+ */
+static int fdtw_edit_nameoff(const void *dtb, const fdtw_edit_t *edits,
+		unsigned int num, const char *name, unsigned int *new_size,
+		int *new_name)
+{
+	const char *strtab = (const char *)dtb + fdt_off_dt_strings(dtb);
+	int size = (int)fdt_size_dt_strings(dtb);
+	int len = (int)strlen(name);
+	int i, n;
+
+	*new_name = 0;
+
+	for (i = 0; i <= size - (len + 1); i++) {
+		if (memcmp(strtab + i, name, (size_t)len + 1U) == 0)
+			return i;
+	}
+
+	/* The names added by the batch so far, in the order they were added */
+	for (i = 0; i < (int)num; i++) {
+		if (edits[i].new_name == 0)
+			continue;
+		n = (int)strlen(edits[i].name);
+		if ((n >= len) && (strcmp(edits[i].name + n - len, name) == 0))
+			return edits[i].nameoff + n - len;
+	}
+
+	*new_name = 1;
+	i = size + (int)*new_size;
+	*new_size += (unsigned int)len + 1U;
+
+	return i;
+}
+
+/* Check the structure block of the blob, which is then parsed without libfdt */
+static int fdtw_edit_check_struct(const void *dtb)
+{
+	int offset = 0, next, depth = 0;
+	uint32_t tag;
+
+	do {
+		tag = fdt_next_tag(dtb, offset, &next);
+		if (next < 0)
+			return next;
+		if (tag == FDT_BEGIN_NODE) {
+			if (++depth > FDTW_EDIT_MAX_DEPTH)
+				return -FDT_ERR_BADSTRUCTURE;
+		} else if (tag == FDT_END_NODE) {
+			if (--depth < 0)
+				return -FDT_ERR_BADSTRUCTURE;
+		}
+		offset = next;
+	} while (tag != FDT_END);
+
+	if ((depth != 0) || ((unsigned int)offset != fdt_size_dt_struct(dtb)))
+		return -FDT_ERR_BADSTRUCTURE;
+
+	return 0;
+}
+
+/*
+ * Validate the edits, group the ones on the same property and work out the
+ * size and layout of the result. '*growth' is how much the blob grows overall,
+ * while '*max_growth' ignores the properties which shrink and is the extra
+ * space needed to edit the blob in place.
+ */
+static int fdtw_edit_prepare(const void *dtb, fdtw_edit_t *edits,
+		unsigned int num_edits, int *growth, unsigned int *max_growth)
+{
+	const struct fdt_property *prop;
+	fdtw_edit_t *edit, *first;
+	unsigned int i, j, new_strings = 0;
+	int delta, len;
+
+	*growth = 0;
+	*max_growth = 0;
+
+	for (i = 0; i < num_edits; i++) {
+		edit = &edits[i];
+		edit->seq = (int)i;
+		edit->group = (int)i;
+		edit->old_len = -1;
+		edit->new_name = 0;
+
+		if ((edit->name == NULL) || (edit->len < 0) ||
+		    ((edit->len > 0) && (edit->value == NULL)) ||
+		    (edit->op > FDTW_EDIT_ADD_SUBNODE))
+			return -FDT_ERR_BADVALUE;
+
+		if (edit->node < 0) {
+			/* Node added by an earlier edit of the batch */
+			j = (unsigned int)(-2 - edit->node);
+			if ((edit->node > -2) || (j >= i) ||
+			    (edits[j].op != FDTW_EDIT_ADD_SUBNODE))
+				return -FDT_ERR_BADOFFSET;
+		} else if (fdt_get_name(dtb, edit->node, NULL) == NULL) {
+			return -FDT_ERR_BADOFFSET;
+		}
+
+		if (edit->op == FDTW_EDIT_ADD_SUBNODE) {
+			for (j = 0; j < i; j++) {
+				if ((edits[j].op == FDTW_EDIT_ADD_SUBNODE) &&
+				    (edits[j].node == edit->node) &&
+				    (strcmp(edits[j].name, edit->name) == 0))
+					return -FDT_ERR_EXISTS;
+			}
+			if ((edit->node >= 0) &&
+			    (fdt_subnode_offset(dtb, edit->node,
+						edit->name) >= 0))
+				return -FDT_ERR_EXISTS;
+
+			delta = (int)(sizeof(struct fdt_node_header) +
+				FDTW_TAGALIGN(strlen(edit->name) + 1U) +
+				FDT_TAGSIZE);
+			*growth += delta;
+			*max_growth += (unsigned int)delta;
+			continue;
+		}
+
+		for (j = 0; j < i; j++) {
+			first = &edits[j];
+			if (fdtw_is_group_first(first) &&
+			    (first->node == edit->node) &&
+			    (strcmp(first->name, edit->name) == 0))
+				break;
+		}
+
+		if (j < i) {
+			/* Later edit of a property already edited */
+			edit->group = first->group;
+			if (edit->op == FDTW_EDIT_SETPROP)
+				first->total_len = edit->len;
+			else
+				first->total_len += edit->len;
+			continue;
+		}
+
+		if (edit->node >= 0) {
+			prop = fdt_get_property(dtb, edit->node, edit->name,
+					&len);
+			if (prop != NULL) {
+				edit->old_len = len;
+				edit->old_offset = (int)((const char *)prop -
+					((const char *)dtb +
+					 fdt_off_dt_struct(dtb)));
+				edit->nameoff = (int)fdt32_to_cpu(prop->nameoff);
+			} else if (len != -FDT_ERR_NOTFOUND) {
+				return len;
+			}
+		}
+
+		edit->total_len = edit->len;
+		if (edit->old_len < 0) {
+			edit->nameoff = fdtw_edit_nameoff(dtb, edits, i,
+					edit->name, &new_strings,
+					&edit->new_name);
+		} else if (edit->op == FDTW_EDIT_APPENDPROP) {
+			edit->total_len += edit->old_len;
+		}
+	}
+
+	for (i = 0; i < num_edits; i++) {
+		edit = &edits[i];
+		if (!fdtw_is_group_first(edit))
+			continue;
+		if (edit->old_len >= 0)
+			delta = (int)FDTW_TAGALIGN((unsigned int)edit->total_len) -
+				(int)FDTW_TAGALIGN((unsigned int)edit->old_len);
+		else
+			delta = (int)(sizeof(struct fdt_property) +
+				FDTW_TAGALIGN((unsigned int)edit->total_len));
+		*growth += delta;
+		if (delta > 0)
+			*max_growth += (unsigned int)delta;
+	}
+
+	*growth += (int)new_strings;
+	*max_growth += new_strings;
+
+	return 0;
+}
+
+/* Sort the edits by node, keeping the order of the batch for each node */
+static void fdtw_edit_sort(fdtw_edit_t *edits, unsigned int num_edits)
+{
+	fdtw_edit_t tmp;
+	unsigned int gap, i, j;
+
+	for (gap = num_edits / 2U; gap > 0U; gap /= 2U) {
+		for (i = gap; i < num_edits; i++) {
+			tmp = edits[i];
+			for (j = i; j >= gap; j -= gap) {
+				if ((edits[j - gap].node < tmp.node) ||
+				    ((edits[j - gap].node == tmp.node) &&
+				     (edits[j - gap].seq < tmp.seq)))
+					break;
+				edits[j] = edits[j - gap];
+			}
+			edits[j] = tmp;
+		}
+	}
+}
+
+/*
+ * Return in [*start, *end) the sorted edits on 'node', looking from '*start'
+ * onwards.
+ */
+static void fdtw_edit_range(const fdtw_edit_ctx_t *ctx, int node,
+		unsigned int *start, unsigned int *end)
+{
+	unsigned int i = *start;
+
+	while ((i < ctx->num_edits) && (ctx->edits[i].node < node))
+		i++;
+	*start = i;
+	while ((i < ctx->num_edits) && (ctx->edits[i].node == node))
+		i++;
+	*end = i;
+}
+
+static uint32_t fdtw_get32(const uint8_t *p)
+{
+	fdt32_t val;
+
+	memcpy(&val, p, sizeof(val));
+	return fdt32_to_cpu(val);
+}
+
+static void fdtw_put32(fdtw_edit_ctx_t *ctx, uint32_t val)
+{
+	fdt32_t v = cpu_to_fdt32(val);
+
+	memcpy(ctx->out_struct + ctx->pos, &v, sizeof(v));
+	ctx->pos += (unsigned int)sizeof(v);
+}
+
+/* The source may overlap the output when editing in place */
+static void fdtw_put(fdtw_edit_ctx_t *ctx, const void *data, unsigned int len)
+{
+	memmove(ctx->out_struct + ctx->pos, data, len);
+	ctx->pos += len;
+}
+
+static void fdtw_pad(fdtw_edit_ctx_t *ctx)
+{
+	while ((ctx->pos % FDT_TAGSIZE) != 0U)
+		ctx->out_struct[ctx->pos++] = 0U;
+}
+
+/*
+ * Emit the property edited by 'first' and the other edits of its group among
+ * the sorted edits [start, end). 'old' is the current value of the property,
+ * if it exists.
+ */
+static void fdtw_emit_prop(fdtw_edit_ctx_t *ctx, const fdtw_edit_t *first,
+		unsigned int start, unsigned int end, const void *old)
+{
+	const fdtw_edit_t *edit;
+	unsigned int i, base = start;
+	int set = 0;
+
+	/* The value starts at the last fdt_setprop() of the group, if any */
+	for (i = start; i < end; i++) {
+		edit = &ctx->edits[i];
+		if ((edit->group == first->seq) &&
+		    (edit->op == FDTW_EDIT_SETPROP)) {
+			base = i;
+			set = 1;
+		}
+	}
+
+	fdtw_put32(ctx, FDT_PROP);
+	fdtw_put32(ctx, (uint32_t)first->total_len);
+	fdtw_put32(ctx, (uint32_t)first->nameoff);
+
+	if ((set == 0) && (first->old_len > 0))
+		fdtw_put(ctx, old, (unsigned int)first->old_len);
+
+	for (i = base; i < end; i++) {
+		edit = &ctx->edits[i];
+		if ((edit->group == first->seq) && (edit->len > 0))
+			fdtw_put(ctx, edit->value, (unsigned int)edit->len);
+	}
+
+	fdtw_pad(ctx);
+}
+
+/*
+ * Emit the properties added by the sorted edits [start, end). libfdt inserts
+ * new properties first in their node, so the newest comes first.
+ */
+static void fdtw_emit_new_props(fdtw_edit_ctx_t *ctx, unsigned int start,
+		unsigned int end)
+{
+	const fdtw_edit_t *edit;
+	unsigned int i;
+
+	for (i = end; i > start; i--) {
+		edit = &ctx->edits[i - 1U];
+		if (fdtw_is_group_first(edit) && (edit->old_len < 0))
+			fdtw_emit_prop(ctx, edit, start, end, NULL);
+	}
+}
+
+/*
+ * Emit the subnodes added by the sorted edits [start, end), with their own
+ * properties and subnodes. libfdt inserts new subnodes right after the
+ * properties of their parent, so the newest comes first.
+ */
+static void fdtw_emit_new_subnodes(fdtw_edit_ctx_t *ctx, unsigned int start,
+		unsigned int end)
+{
+	const fdtw_edit_t *edit;
+	unsigned int i, sub_start, sub_end;
+
+	for (i = end; i > start; i--) {
+		edit = &ctx->edits[i - 1U];
+		if (edit->op != FDTW_EDIT_ADD_SUBNODE)
+			continue;
+
+		fdtw_put32(ctx, FDT_BEGIN_NODE);
+		fdtw_put(ctx, edit->name, (unsigned int)strlen(edit->name) + 1U);
+		fdtw_pad(ctx);
+
+		sub_start = 0;
+		fdtw_edit_range(ctx, FDTW_EDIT_NEW_NODE(edit->seq), &sub_start,
+				&sub_end);
+		fdtw_emit_new_props(ctx, sub_start, sub_end);
+		fdtw_emit_new_subnodes(ctx, sub_start, sub_end);
+
+		fdtw_put32(ctx, FDT_END_NODE);
+	}
+}
+
+/* Write the structure block of the result, applying the sorted edits */
+static void fdtw_edit_struct(fdtw_edit_ctx_t *ctx)
+{
+	struct {
+		unsigned int start;
+		unsigned int end;
+		int subnodes_pending;
+	} stack[FDTW_EDIT_MAX_DEPTH + 1], *cur = &stack[0];
+	unsigned int offset = 0, next, cursor = 0, len, i;
+	const fdtw_edit_t *edit;
+	uint32_t tag;
+
+	/* The edits on new nodes come first, skip them */
+	while ((cursor < ctx->num_edits) && (ctx->edits[cursor].node < 0))
+		cursor++;
+	cur->start = cursor;
+	cur->end = cursor;
+	cur->subnodes_pending = 0;
+
+	do {
+		tag = fdtw_get32(ctx->in_struct + offset);
+
+		if (((tag == FDT_BEGIN_NODE) || (tag == FDT_END_NODE)) &&
+		    (cur->subnodes_pending != 0)) {
+			fdtw_emit_new_subnodes(ctx, cur->start, cur->end);
+			cur->subnodes_pending = 0;
+		}
+
+		switch (tag) {
+		case FDT_BEGIN_NODE:
+			next = offset + FDT_TAGSIZE + FDTW_TAGALIGN((unsigned int)
+				strlen((const char *)ctx->in_struct + offset +
+				       FDT_TAGSIZE) + 1U);
+			fdtw_put(ctx, ctx->in_struct + offset, next - offset);
+
+			cur++;
+			cur->start = cursor;
+			fdtw_edit_range(ctx, (int)offset, &cur->start,
+					&cur->end);
+			cursor = cur->end;
+			cur->subnodes_pending = (cur->start != cur->end) ? 1 : 0;
+
+			fdtw_emit_new_props(ctx, cur->start, cur->end);
+			break;
+
+		case FDT_PROP:
+			len = fdtw_get32(ctx->in_struct + offset + FDT_TAGSIZE);
+			next = offset + (unsigned int)sizeof(struct fdt_property) +
+				FDTW_TAGALIGN(len);
+
+			for (i = cur->start; i < cur->end; i++) {
+				edit = &ctx->edits[i];
+				if (fdtw_is_group_first(edit) &&
+				    (edit->old_len >= 0) &&
+				    (edit->old_offset == (int)offset))
+					break;
+			}
+
+			if (i < cur->end)
+				fdtw_emit_prop(ctx, &ctx->edits[i], cur->start,
+					cur->end, ctx->in_struct + offset +
+					sizeof(struct fdt_property));
+			else
+				fdtw_put(ctx, ctx->in_struct + offset,
+					next - offset);
+			break;
+
+		case FDT_END_NODE:
+			next = offset + FDT_TAGSIZE;
+			fdtw_put(ctx, ctx->in_struct + offset, FDT_TAGSIZE);
+			cur--;
+			break;
+
+		default:
+			/* FDT_NOP or FDT_END */
+			next = offset + FDT_TAGSIZE;
+			fdtw_put(ctx, ctx->in_struct + offset, FDT_TAGSIZE);
+			break;
+		}
+
+		offset = next;
+	} while (tag != FDT_END);
+}
+
+/*
+ * Apply a batch of edits to the blob 'dtb' and write the result to 'out', a
+ * buffer of 'out_size' bytes which is either 'dtb' itself or doesn't overlap
+ * it. The edits are applied as if by calls to fdt_setprop(), fdt_appendprop()
+ * and fdt_add_subnode() in the order of the array, but the blob is written only
+ * once. The node of an edit is either an offset in 'dtb', or
+ * FDTW_EDIT_NEW_NODE(i) for the node added by the earlier edit at index i.
+ *
+ * As with fdt_open_into(), the total size of the result is 'out_size'. The
+ * values of the edits must not be in 'out', and the array of edits is
+ * reordered. Returns 0 on success or a negative libfdt error code, in which
+ * case neither the blob nor 'out' have been modified.
+ */
+int fdtw_apply_edits(const void *dtb, void *out, size_t out_size,
+		fdtw_edit_t *edits, unsigned int num_edits)
+{
+	struct fdt_header hdr;
+	fdtw_edit_ctx_t ctx;
+	const uint8_t *in;
+	char *strings;
+	unsigned int max_growth, used, new_used, struct_size, off_strings, i;
+	int growth, err;
+
+	assert(dtb != NULL);
+	assert(out != NULL);
+	assert((edits != NULL) || (num_edits == 0U));
+
+	err = fdt_check_header(dtb);
+	if (err != 0)
+		return err;
+	if (fdt_version(dtb) < 17)
+		return -FDT_ERR_BADVERSION;
+	if ((fdt_off_mem_rsvmap(dtb) > fdt_off_dt_struct(dtb)) ||
+	    ((fdt_off_dt_struct(dtb) + fdt_size_dt_struct(dtb)) >
+	     fdt_off_dt_strings(dtb)) ||
+	    ((fdt_off_dt_strings(dtb) + fdt_size_dt_strings(dtb)) >
+	     fdt_totalsize(dtb)))
+		return -FDT_ERR_BADLAYOUT;
+
+	err = fdtw_edit_check_struct(dtb);
+	if (err != 0)
+		return err;
+
+	err = fdtw_edit_prepare(dtb, edits, num_edits, &growth, &max_growth);
+	if (err != 0)
+		return err;
+
+	used = fdt_off_dt_strings(dtb) + fdt_size_dt_strings(dtb);
+	new_used = (unsigned int)((int)used + growth);
+	if (((out == dtb) && ((used + max_growth) > out_size)) ||
+	    (new_used > out_size))
+		return -FDT_ERR_NOSPACE;
+
+	memcpy(&hdr, dtb, sizeof(hdr));
+
+	/*
+	 * To edit in place, first move the blob to the end of the buffer. The
+	 * result is then written from the start of the buffer without ever
+	 * catching up with what is left to read.
+	 */
+	in = dtb;
+	if (out == dtb) {
+		in = (uint8_t *)out + out_size - used;
+		memmove((void *)in, dtb, used);
+	}
+
+	fdtw_edit_sort(edits, num_edits);
+
+	/* Header and memory reservation block */
+	memmove(out, in, fdt32_to_cpu(hdr.off_dt_struct));
+
+	ctx.out_struct = (uint8_t *)out + fdt32_to_cpu(hdr.off_dt_struct);
+	ctx.pos = 0;
+	ctx.in_struct = in + fdt32_to_cpu(hdr.off_dt_struct);
+	ctx.edits = edits;
+	ctx.num_edits = num_edits;
+	fdtw_edit_struct(&ctx);
+
+	/* Anything between the structure and strings blocks, then the strings */
+	struct_size = ctx.pos;
+	fdtw_put(&ctx, ctx.in_struct + fdt32_to_cpu(hdr.size_dt_struct),
+		 used - fdt32_to_cpu(hdr.off_dt_struct) -
+		 fdt32_to_cpu(hdr.size_dt_struct));
+
+	/* Names of the new properties, at the offsets worked out beforehand */
+	off_strings = fdt32_to_cpu(hdr.off_dt_strings) + struct_size -
+		fdt32_to_cpu(hdr.size_dt_struct);
+	strings = (char *)out + off_strings;
+	for (i = 0; i < num_edits; i++) {
+		if (edits[i].new_name != 0)
+			memcpy(strings + edits[i].nameoff, edits[i].name,
+			       strlen(edits[i].name) + 1U);
+	}
+
+	memset((uint8_t *)out + new_used, 0, out_size - new_used);
+
+	fdt_set_totalsize(out, (uint32_t)out_size);
+	fdt_set_size_dt_struct(out, struct_size);
+	fdt_set_off_dt_strings(out, off_strings);
+	fdt_set_size_dt_strings(out, new_used - off_strings);
+
+	return 0;
+}
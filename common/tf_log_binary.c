@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <binary_log.h>
+#include <cassert.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+
+/*
+ * Binary log of BL31. Instead of being formatted and printed, the messages are
+ * recorded as the ID of their format string and their raw arguments, in a ring
+ * of the calling CPU so that no locking is needed. The format strings are kept
+ * in a section which is not loaded, and the log is rendered on the host by
+ * tools/logdecode from the BL31 ELF file and a dump of the log.
+ *
+ * The platform can place the log in memory shared with the Normal world by
+ * defining PLAT_BINARY_LOG_BASE, in which case it must be mapped by BL31.
+ */
+
+#ifndef PLAT_BINARY_LOG_RECORDS
+#define PLAT_BINARY_LOG_RECORDS		32
+#endif
+
+#define BINARY_LOG_RING_SIZE						\
+	(sizeof(binary_log_ring_t) +					\
+	 (PLAT_BINARY_LOG_RECORDS * sizeof(binary_log_record_t)))
+
+#define BINARY_LOG_SIZE							\
+	(sizeof(binary_log_header_t) +					\
+	 (PLATFORM_CORE_COUNT * BINARY_LOG_RING_SIZE))
+
+CASSERT((sizeof(binary_log_header_t) % sizeof(uint64_t)) == 0,
+	assert_binary_log_header_size);
+CASSERT((PLAT_BINARY_LOG_RECORDS & (PLAT_BINARY_LOG_RECORDS - 1)) == 0,
+	assert_binary_log_records_power_of_two);
+
+#ifdef PLAT_BINARY_LOG_BASE
+CASSERT(PLAT_BINARY_LOG_SIZE >= BINARY_LOG_SIZE, assert_binary_log_size);
+#define binary_log	((uint8_t *)PLAT_BINARY_LOG_BASE)
+#else
+static uint8_t binary_log[BINARY_LOG_SIZE] __aligned(CACHE_WRITEBACK_GRANULE);
+#endif
+
+/* Start of the section of the format strings, defined by the linker script */
+extern const char __TF_LOG_FMT_START__[];
+
+static binary_log_ring_t *binary_log_ring(unsigned int cpu)
+{
+	return (binary_log_ring_t *)(binary_log + sizeof(binary_log_header_t) +
+				     (cpu * BINARY_LOG_RING_SIZE));
+}
+
+/*******************************************************************************
+ * Record a message in the ring of the calling CPU. 'fmt' points to the format
+ * string of the message in the format string section, and 'args' holds its
+ * 'nargs' arguments. Only meant to be used by the log macros in debug.h.
+ ******************************************************************************/
+void tf_log_binary(const char *fmt, unsigned int level, unsigned int nargs,
+		   const u_register_t *args)
+{
+	binary_log_ring_t *ring = binary_log_ring(plat_my_core_pos());
+	binary_log_record_t *record;
+	unsigned int i;
+
+	assert(nargs <= BINARY_LOG_MAX_ARGS);
+
+	record = &ring->record[ring->seq & (PLAT_BINARY_LOG_RECORDS - 1)];
+	record->info = ((uint64_t)(fmt - __TF_LOG_FMT_START__) <<
+			BINARY_LOG_FMT_SHIFT) |
+		       ((uint64_t)level << BINARY_LOG_LEVEL_SHIFT) |
+		       ((uint64_t)nargs << BINARY_LOG_NARGS_SHIFT);
+	record->timestamp = read_cntpct_el0();
+	for (i = 0; i < nargs; i++)
+		record->args[i] = args[i];
+
+	/* Publish the record only after it has been fully written */
+	dmbish();
+	ring->seq++;
+}
+
+/*******************************************************************************
+ * Initialise the header of the binary log. Called by BL31 on the primary CPU
+ * during cold boot. The rings of the static log are in .bss and already hold the
+ * messages of the early platform setup, but a log provided by the platform has
+ * to be emptied here.
+ ******************************************************************************/
+void tf_log_binary_init(void)
+{
+	binary_log_header_t *header = (binary_log_header_t *)binary_log;
+#ifdef PLAT_BINARY_LOG_BASE
+	unsigned int i;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		binary_log_ring(i)->seq = 0;
+#endif
+
+	header->version = BINARY_LOG_VERSION;
+	header->cpu_count = PLATFORM_CORE_COUNT;
+	header->records = PLAT_BINARY_LOG_RECORDS;
+	header->reserved = 0;
+
+	/* Make the log valid only once it is fully initialised */
+	dmbish();
+	header->magic = BINARY_LOG_MAGIC;
+
+	flush_dcache_range((uintptr_t)binary_log, BINARY_LOG_SIZE);
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <cassert.h>
+#include <console.h>
+#include <debug.h>
+#include <platform.h>
+#include <platform_def.h>
+#include <spinlock.h>
+
+/*
+ * Per-CPU buffering of the console output of BL31 at runtime. Each CPU appends
+ * the characters it prints to its own ring, without taking any lock, and the
+ * rings are drained to the registered consoles later on:
+ *
+ * - when a CPU is about to power down, for CPU_OFF or a power down suspend,
+ * - when the ring of the printing CPU is full,
+ * - when tf_log_ring_flush() is called explicitly.
+ *
+ * Printing a line therefore never waits for the console, unless the ring of the
+ * CPU is full. On panic, assert and system off or reset, tf_log_ring_stop()
+ * outputs all the buffered characters and disables the buffering.
+ *
+ * Each ring has a single producer, its CPU, which alone updates 'head'. Draining
+ * is serialised by 'log_ring_lock', and only the drainer updates 'tail'.
+ */
+
+#ifndef PLAT_LOG_RING_SIZE
+#define PLAT_LOG_RING_SIZE	1024
+#endif
+
+CASSERT((PLAT_LOG_RING_SIZE & (PLAT_LOG_RING_SIZE - 1)) == 0,
+	assert_log_ring_size_power_of_two);
+
+typedef struct log_ring {
+	volatile unsigned int head;
+	volatile unsigned int tail;
+	char buf[PLAT_LOG_RING_SIZE];
+} __aligned(CACHE_WRITEBACK_GRANULE) log_ring_t;
+
+static log_ring_t log_rings[PLATFORM_CORE_COUNT];
+static spinlock_t log_ring_lock;
+
+/* Buffering is only enabled at runtime, the boot messages are printed as is */
+static int log_ring_enabled;
+
+/*
+ * Output the characters of 'ring'. Unless 'all' is set, only complete lines are
+ * output so that lines from different CPUs don't get mixed up. Must be called
+ * with 'log_ring_lock' held, except by tf_log_ring_stop().
+ */
+static void log_ring_drain(log_ring_t *ring, int all)
+{
+	unsigned int head, tail, end;
+
+	head = ring->head;
+	tail = ring->tail;
+
+	/* Read the characters only after the head which publishes them */
+	dmbish();
+
+	end = head;
+	if (all == 0) {
+		while ((end != tail) &&
+		       (ring->buf[(end - 1) & (PLAT_LOG_RING_SIZE - 1)] != '\n'))
+			end--;
+	}
+
+	while (tail != end) {
+		(void)console_putc(ring->buf[tail & (PLAT_LOG_RING_SIZE - 1)]);
+		tail++;
+	}
+
+	/* Release the space only after the characters have been read */
+	dmbish();
+	ring->tail = tail;
+}
+
+/*
+ * The rings are only coherent once the data cache of the calling CPU is
+ * enabled, which isn't the case early in its warm boot. The characters printed
+ * until then are output directly.
+ */
+static int log_ring_usable(void)
+{
+	return (log_ring_enabled != 0) &&
+	       ((read_sctlr_el3() & SCTLR_C_BIT) != 0U);
+}
+
+/*
+ * Append a character to the ring of the calling CPU. Returns 0 if it has been
+ * buffered, or -1 if it must be output directly.
+ */
+int tf_log_ring_putc(int c)
+{
+	log_ring_t *ring;
+	unsigned int head;
+
+	if (log_ring_usable() == 0)
+		return -1;
+
+	ring = &log_rings[plat_my_core_pos()];
+	head = ring->head;
+
+	if ((head - ring->tail) == PLAT_LOG_RING_SIZE) {
+		spin_lock(&log_ring_lock);
+		log_ring_drain(ring, 1);
+		spin_unlock(&log_ring_lock);
+	}
+
+	ring->buf[head & (PLAT_LOG_RING_SIZE - 1)] = (char)c;
+
+	/* Publish the character only after it has been written */
+	dmbish();
+	ring->head = head + 1;
+
+	return 0;
+}
+
+/*
+ * Output the buffered characters of all the CPUs. The pending output of the
+ * calling CPU is flushed completely, partial lines included.
+ */
+void tf_log_ring_flush(void)
+{
+	unsigned int me, i;
+
+	if (log_ring_usable() == 0)
+		return;
+
+	me = plat_my_core_pos();
+
+	spin_lock(&log_ring_lock);
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		log_ring_drain(&log_rings[i], i == me);
+	spin_unlock(&log_ring_lock);
+
+	(void)console_flush();
+}
+
+/*
+ * Output all the buffered characters, partial lines included, and stop the
+ * buffering. Used on the panic, assert and system off or reset paths: the lock
+ * isn't taken as it may be held by the calling CPU itself, so the output of
+ * CPUs still printing may get mixed up.
+ */
+void tf_log_ring_stop(void)
+{
+	unsigned int i;
+
+	if (log_ring_usable() == 0)
+		return;
+
+	log_ring_enabled = 0;
+
+	for (i = 0; i < PLATFORM_CORE_COUNT; i++)
+		log_ring_drain(&log_rings[i], 1);
+
+	(void)console_flush();
+}
+
+/*
+ * Start buffering the console output. Called once the cold boot of BL31 is
+ * complete and the system is fully coherent.
+ */
+void tf_log_ring_enable(void)
+{
+	log_ring_enabled = 1;
+}
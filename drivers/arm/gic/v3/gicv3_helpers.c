@@ -544,56 +544,91 @@ void gicv3_secure_ppi_sgi_config(uintptr_t gicr_base,
 #endif
 
 /*******************************************************************************
- * Helper function to configure properties of secure G0 and G1S PPIs and SGIs.
+ * Helper function to configure the default attributes of SGIs and PPIs, along
+ * with the properties of the secure G0 and G1S ones. The configuration is
+ * first accumulated into register-wide values, so that each Redistributor
+ * register is written once.
  ******************************************************************************/
-unsigned int gicv3_secure_ppi_sgi_config_props(uintptr_t gicr_base,
+unsigned int gicv3_ppi_sgi_config_props(uintptr_t gicr_base,
 		const interrupt_prop_t *interrupt_props,
 		unsigned int interrupt_props_num)
 {
-	unsigned int i;
+	unsigned int i, id, shift;
 	const interrupt_prop_t *current_prop;
 	unsigned int ctlr_enable = 0;
+	unsigned int igroupr, igrpmodr, icfgr1, isenabler;
+	unsigned int ipriorityr[MIN_SPI_ID >> IPRIORITYR_SHIFT];
 
 	/* Make sure there's a valid property array */
 	assert(interrupt_props_num > 0 ? interrupt_props != NULL : 1);
 
+	/*
+	 * Treat all SGIs/PPIs as G1NS, with the default priority, and configure
+	 * all PPIs as level triggered by default.
+	 */
+	igroupr = ~0U;
+	igrpmodr = gicr_read_igrpmodr0(gicr_base);
+	icfgr1 = 0;
+	isenabler = 0;
+	for (i = 0; i < ARRAY_SIZE(ipriorityr); i++)
+		ipriorityr[i] = GICD_IPRIORITYR_DEF_VAL;
+
 	for (i = 0; i < interrupt_props_num; i++) {
 		current_prop = &interrupt_props[i];
+		id = current_prop->intr_num;
 
-		if (current_prop->intr_num >= MIN_SPI_ID)
+		if (id >= MIN_SPI_ID)
 			continue;
 
 		/* Configure this interrupt as a secure interrupt */
-		gicr_clr_igroupr0(gicr_base, current_prop->intr_num);
+		igroupr &= ~(1U << id);
 
 		/* Configure this interrupt as G0 or a G1S interrupt */
 		assert((current_prop->intr_grp == INTR_GROUP0) ||
 				(current_prop->intr_grp == INTR_GROUP1S));
 		if (current_prop->intr_grp == INTR_GROUP1S) {
-			gicr_set_igrpmodr0(gicr_base, current_prop->intr_num);
+			igrpmodr |= (1U << id);
 			ctlr_enable |= CTLR_ENABLE_G1S_BIT;
 		} else {
-			gicr_clr_igrpmodr0(gicr_base, current_prop->intr_num);
+			igrpmodr &= ~(1U << id);
 			ctlr_enable |= CTLR_ENABLE_G0_BIT;
 		}
 
 		/* Set the priority of this interrupt */
-		gicr_set_ipriorityr(gicr_base, current_prop->intr_num,
-				current_prop->intr_pri);
+		shift = (id & ((1U << IPRIORITYR_SHIFT) - 1)) << 3;
+		ipriorityr[id >> IPRIORITYR_SHIFT] &= ~(GIC_PRI_MASK << shift);
+		ipriorityr[id >> IPRIORITYR_SHIFT] |=
+			(current_prop->intr_pri & GIC_PRI_MASK) << shift;
 
 		/*
 		 * Set interrupt configuration for PPIs. Configuration for SGIs
 		 * are ignored.
 		 */
-		if ((current_prop->intr_num >= MIN_PPI_ID) &&
-				(current_prop->intr_num < MIN_SPI_ID)) {
-			gicr_set_icfgr1(gicr_base, current_prop->intr_num,
-					current_prop->intr_cfg);
+		if (id >= MIN_PPI_ID) {
+			shift = (id & ((1U << ICFGR_SHIFT) - 1)) << 1;
+			icfgr1 &= ~(GIC_CFG_MASK << shift);
+			icfgr1 |= (current_prop->intr_cfg & GIC_CFG_MASK) << shift;
 		}
 
 		/* Enable this interrupt */
-		gicr_set_isenabler0(gicr_base, current_prop->intr_num);
+		isenabler |= (1U << id);
 	}
 
+	/*
+	 * Disable all SGIs (imp. def.)/PPIs before configuring them. This is a
+	 * more scalable approach as it avoids clearing the enable bits in the
+	 * GICD_CTLR
+	 */
+	gicr_write_icenabler0(gicr_base, ~0U);
+	gicr_wait_for_pending_write(gicr_base);
+
+	gicr_write_igroupr0(gicr_base, igroupr);
+	gicr_write_igrpmodr0(gicr_base, igrpmodr);
+	for (i = 0; i < ARRAY_SIZE(ipriorityr); i++)
+		gicr_write_ipriorityr(gicr_base, i << IPRIORITYR_SHIFT,
+				ipriorityr[i]);
+	gicr_write_icfgr1(gicr_base, icfgr1);
+	gicr_write_isenabler0(gicr_base, isenabler);
+
 	return ctlr_enable;
 }
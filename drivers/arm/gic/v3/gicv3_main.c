@@ -31,13 +31,20 @@ static spinlock_t gic_lock;
 #pragma weak gicv3_rdistif_on
 
 
-/* Helper macros to save and restore GICD registers to and from the context */
-#define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG)		\
+/*
+ * Helper macros to save and restore GICD registers to and from the context.
+ * When 'dirty_only' is set, the registers which already hold the value in the
+ * context are not written.
+ */
+#define RESTORE_GICD_REGS(base, ctx, intr_num, reg, REG, dirty_only)	\
 	do {								\
 		for (unsigned int int_id = MIN_SPI_ID; int_id < intr_num; \
 				int_id += (1 << REG##_SHIFT)) {		\
-			gicd_write_##reg(base, int_id,			\
-				ctx->gicd_##reg[(int_id - MIN_SPI_ID) >> REG##_SHIFT]); \
+			unsigned int idx = (int_id - MIN_SPI_ID) >> REG##_SHIFT; \
+			if ((dirty_only) && (gicd_read_##reg(base, int_id) == \
+					ctx->gicd_##reg[idx]))		\
+				continue;				\
+			gicd_write_##reg(base, int_id, ctx->gicd_##reg[idx]); \
 		}							\
 	} while (0)
 
@@ -263,17 +270,21 @@ void gicv3_rdistif_init(unsigned int proc_num)
 
 	gicr_base = gicv3_driver_data->rdistif_base_addrs[proc_num];
 
-	/* Set the default attribute of all SGIs and PPIs */
-	gicv3_ppi_sgi_config_defaults(gicr_base);
-
 #if !ERROR_DEPRECATED
 	if (gicv3_driver_data->interrupt_props != NULL) {
 #endif
-		bitmap = gicv3_secure_ppi_sgi_config_props(gicr_base,
+		/*
+		 * Set the default attribute of all SGIs and PPIs, and configure
+		 * the secure ones, writing each register once.
+		 */
+		bitmap = gicv3_ppi_sgi_config_props(gicr_base,
 				gicv3_driver_data->interrupt_props,
 				gicv3_driver_data->interrupt_props_num);
 #if !ERROR_DEPRECATED
 	} else {
+		/* Set the default attribute of all SGIs and PPIs */
+		gicv3_ppi_sgi_config_defaults(gicr_base);
+
 		/*
 		 * Suppress deprecated declaration warnings in compatibility
 		 * function
@@ -781,10 +792,15 @@ void gicv3_distif_save(gicv3_dist_ctx_t * const dist_ctx)
  * function must be invoked prior to Redistributor restore and CPU interface
  * enable. The pending and active interrupts are restored after the interrupts
  * are fully configured and enabled.
+ *
+ * With GICV3_DIST_RESTORE_DIRTY, if the Distributor kept its state while
+ * suspended, only the registers which don't hold their saved value anymore are
+ * written back.
  *****************************************************************************/
 void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 {
 	unsigned int num_ints = 0;
+	unsigned int dirty_only = 0;
 
 	assert(gicv3_driver_data);
 	assert(gicv3_driver_data->gicd_base);
@@ -793,6 +809,15 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 
 	uintptr_t gicd_base = gicv3_driver_data->gicd_base;
 
+#if GICV3_DIST_RESTORE_DIRTY
+	/*
+	 * This driver always runs the Distributor with affinity routing enabled
+	 * for the Secure state, so a clear GICD_CTLR.ARE_S bit means that the
+	 * Distributor was reset while suspended.
+	 */
+	dirty_only = (gicd_read_ctlr(gicd_base) & CTLR_ARE_S_BIT) != 0U;
+#endif
+
 	/*
 	 * Clear the "enable" bits for G0/G1S/G1NS interrupts before configuring
 	 * the ARE_S bit. The Distributor might generate a system error
@@ -814,22 +839,28 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	assert(num_ints <= MAX_SPI_ID + 1);
 
 	/* Restore GICD_IGROUPR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igroupr, IGROUPR,
+			dirty_only);
 
 	/* Restore GICD_IPRIORITYR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ipriorityr, IPRIORITYR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ipriorityr, IPRIORITYR,
+			dirty_only);
 
 	/* Restore GICD_ICFGR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, icfgr, ICFGR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, icfgr, ICFGR,
+			dirty_only);
 
 	/* Restore GICD_IGRPMODR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igrpmodr, IGRPMODR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, igrpmodr, IGRPMODR,
+			dirty_only);
 
 	/* Restore GICD_NSACR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr, NSACR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, nsacr, NSACR,
+			dirty_only);
 
 	/* Restore GICD_IROUTER for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, irouter, IROUTER);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, irouter, IROUTER,
+			dirty_only);
 
 	/*
 	 * Restore ISENABLER, ISPENDR and ISACTIVER after the interrupts are
@@ -837,13 +868,16 @@ void gicv3_distif_init_restore(const gicv3_dist_ctx_t * const dist_ctx)
 	 */
 
 	/* Restore GICD_ISENABLER for INT_IDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isenabler, ISENABLER,
+			dirty_only);
 
 	/* Restore GICD_ISPENDR for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, ispendr, ISPENDR,
+			dirty_only);
 
 	/* Restore GICD_ISACTIVER for INTIDs 32 - 1020 */
-	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER);
+	RESTORE_GICD_REGS(gicd_base, dist_ctx, num_ints, isactiver, ISACTIVER,
+			dirty_only);
 
 	/* Restore the GICD_CTLR */
 	gicd_write_ctlr(gicd_base, dist_ctx->gicd_ctlr);
@@ -97,7 +97,7 @@ void gicv3_secure_ppi_sgi_config(uintptr_t gicr_base,
 					const unsigned int *sec_intr_list,
 					unsigned int int_grp);
 #endif
-unsigned int gicv3_secure_ppi_sgi_config_props(uintptr_t gicr_base,
+unsigned int gicv3_ppi_sgi_config_props(uintptr_t gicr_base,
 		const interrupt_prop_t *interrupt_props,
 		unsigned int interrupt_props_num);
 unsigned int gicv3_secure_spis_config_props(uintptr_t gicd_base,
@@ -4,7 +4,12 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <assert.h>
+#include <cassert.h>
 #include <debug.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
 
 /* mbed TLS headers */
 #include <mbedtls/memory_buffer_alloc.h>
@@ -15,13 +20,137 @@
 /*
  * mbed TLS heap
  */
+#ifndef TF_MBEDTLS_HEAP_SIZE
 #if (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_ECDSA) \
 	|| (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA_AND_ECDSA)
 #define MBEDTLS_HEAP_SIZE		(13*1024)
 #elif (TF_MBEDTLS_KEY_ALG_ID == TF_MBEDTLS_RSA)
 #define MBEDTLS_HEAP_SIZE		(7*1024)
 #endif
-static unsigned char heap[MBEDTLS_HEAP_SIZE];
+#else
+#define MBEDTLS_HEAP_SIZE		TF_MBEDTLS_HEAP_SIZE
+#endif
+static unsigned char heap[MBEDTLS_HEAP_SIZE]
+	__aligned(MBEDTLS_MEMORY_ALIGN_MULTIPLE);
+
+#if TF_MBEDTLS_HEAP_ARENA
+/*
+ * Arena (bump) allocator for the mbed TLS heap.
+ *
+ * Every block is preceded by a header that links it to the block allocated
+ * just before it. Allocation simply moves the top of the arena up. Freeing a
+ * block only marks it as free; the top of the arena is then rolled back over
+ * all the free blocks found at the top, so the LIFO allocation pattern of a
+ * signature verification leaves the arena empty. The arena is also reset
+ * explicitly after each verification by mbedtls_heap_reset().
+ */
+typedef struct arena_hdr {
+	/* Offset of the previous block header, or ARENA_NO_BLOCK */
+	uint32_t prev;
+	/* Non-zero once the block has been freed */
+	uint32_t free;
+} arena_hdr_t;
+
+#define ARENA_NO_BLOCK		UINT32_MAX
+#define ARENA_ALIGN(x)		(((x) + (MBEDTLS_MEMORY_ALIGN_MULTIPLE - 1)) \
+				 & ~((size_t)MBEDTLS_MEMORY_ALIGN_MULTIPLE - 1))
+#define ARENA_HDR_SIZE		ARENA_ALIGN(sizeof(arena_hdr_t))
+
+CASSERT(MBEDTLS_HEAP_SIZE < ARENA_NO_BLOCK, assert_mbedtls_heap_size);
+
+static size_t arena_top;
+static uint32_t arena_last = ARENA_NO_BLOCK;
+
+/* Statistics */
+static size_t arena_hwm;
+static size_t arena_alloc_count;
+static size_t arena_fail_count;
+
+static void *arena_calloc(size_t nmemb, size_t size)
+{
+	arena_hdr_t *hdr;
+	size_t len;
+
+	if ((nmemb == 0U) || (size == 0U)) {
+		return NULL;
+	}
+
+	if (size > (MBEDTLS_HEAP_SIZE / nmemb)) {
+		arena_fail_count++;
+		return NULL;
+	}
+
+	len = ARENA_HDR_SIZE + ARENA_ALIGN(nmemb * size);
+	if (len > (MBEDTLS_HEAP_SIZE - arena_top)) {
+		arena_fail_count++;
+		return NULL;
+	}
+
+	hdr = (arena_hdr_t *)&heap[arena_top];
+	hdr->prev = arena_last;
+	hdr->free = 0U;
+	arena_last = (uint32_t)arena_top;
+	arena_top += len;
+
+	if (arena_top > arena_hwm) {
+		arena_hwm = arena_top;
+	}
+	arena_alloc_count++;
+
+	(void)memset((unsigned char *)hdr + ARENA_HDR_SIZE, 0,
+		     len - ARENA_HDR_SIZE);
+
+	return (unsigned char *)hdr + ARENA_HDR_SIZE;
+}
+
+static void arena_free(void *ptr)
+{
+	arena_hdr_t *hdr;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	assert(((unsigned char *)ptr >= &heap[ARENA_HDR_SIZE]) &&
+	       ((unsigned char *)ptr < &heap[arena_top]));
+
+	hdr = (arena_hdr_t *)((unsigned char *)ptr - ARENA_HDR_SIZE);
+	hdr->free = 1U;
+
+	/* Roll the top of the arena back over the free blocks */
+	while (arena_last != ARENA_NO_BLOCK) {
+		hdr = (arena_hdr_t *)&heap[arena_last];
+		if (hdr->free == 0U) {
+			break;
+		}
+		arena_top = arena_last;
+		arena_last = hdr->prev;
+	}
+}
+
+/*
+ * Release every block in the arena. Must only be called once mbed TLS no
+ * longer holds any allocated memory, i.e. between verifications.
+ */
+void mbedtls_heap_reset(void)
+{
+	arena_top = 0U;
+	arena_last = ARENA_NO_BLOCK;
+}
+
+/*
+ * Print the high-water mark of the mbed TLS heap. This allows the heap to be
+ * sized precisely for the key algorithm in use through TF_MBEDTLS_HEAP_SIZE.
+ */
+void mbedtls_heap_print_stats(void)
+{
+	NOTICE("mbed TLS heap: %u/%u bytes used (high-water mark), "
+	       "%u allocations, %u failed\n",
+	       (unsigned int)arena_hwm, (unsigned int)MBEDTLS_HEAP_SIZE,
+	       (unsigned int)arena_alloc_count,
+	       (unsigned int)arena_fail_count);
+}
+#endif /* TF_MBEDTLS_HEAP_ARENA */
 
 /*
  * mbed TLS initialization function
@@ -32,7 +161,12 @@ void mbedtls_init(void)
 
 	if (!ready) {
 		/* Initialize the mbed TLS heap */
+#if TF_MBEDTLS_HEAP_ARENA
+		mbedtls_heap_reset();
+		mbedtls_platform_set_calloc_free(arena_calloc, arena_free);
+#else
 		mbedtls_memory_buffer_alloc_init(heap, MBEDTLS_HEAP_SIZE);
+#endif
 
 #ifdef MBEDTLS_PLATFORM_SNPRINTF_ALT
 		/* Use reduced version of snprintf to save space. */
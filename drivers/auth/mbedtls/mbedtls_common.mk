@@ -20,15 +20,31 @@ INCLUDES		+=	-I${MBEDTLS_DIR}/include		\
 MBEDTLS_CONFIG_FILE	:=	"<mbedtls_config.h>"
 $(eval $(call add_define,MBEDTLS_CONFIG_FILE))
 
+# Use a bump (arena) allocator with high-water-mark reporting for the mbed TLS
+# heap instead of the mbed TLS memory buffer allocator.
+TF_MBEDTLS_HEAP_ARENA	?=	0
+$(eval $(call assert_boolean,TF_MBEDTLS_HEAP_ARENA))
+$(eval $(call add_define,TF_MBEDTLS_HEAP_ARENA))
+
+# The platform may define 'TF_MBEDTLS_HEAP_SIZE' to override the default size
+# of the mbed TLS heap for the selected key algorithm.
+ifdef TF_MBEDTLS_HEAP_SIZE
+    $(eval $(call assert_numeric,TF_MBEDTLS_HEAP_SIZE))
+    $(eval $(call add_define,TF_MBEDTLS_HEAP_SIZE))
+endif
+
 MBEDTLS_COMMON_SOURCES	:=	drivers/auth/mbedtls/mbedtls_common.c	\
 				$(addprefix ${MBEDTLS_DIR}/library/,	\
 				asn1parse.c 				\
 				asn1write.c 				\
-				memory_buffer_alloc.c			\
 				oid.c 					\
 				platform.c 				\
 				platform_util.c				\
 				rsa_internal.c				\
 				)
 
+ifeq (${TF_MBEDTLS_HEAP_ARENA},0)
+    MBEDTLS_COMMON_SOURCES	+=	${MBEDTLS_DIR}/library/memory_buffer_alloc.c
+endif
+
 endif
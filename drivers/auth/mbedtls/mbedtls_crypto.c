@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -131,6 +131,10 @@ end1:
 	mbedtls_pk_free(&pk);
 end2:
 	mbedtls_free(sig_opts);
+#if TF_MBEDTLS_HEAP_ARENA
+	/* Nothing allocated by mbed TLS survives a verification */
+	mbedtls_heap_reset();
+#endif
 	return rc;
 }
 
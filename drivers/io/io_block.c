@@ -28,8 +28,11 @@ io_type_t device_type_block(void);
 static int block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		      io_entity_t *entity);
 static int block_seek(io_entity_t *entity, int mode, ssize_t offset);
+static int block_len(io_entity_t *entity, size_t *length);
 static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 		      size_t *length_read);
+static int block_readv(io_entity_t *entity, const io_iovec_t *iov,
+		       unsigned int iovcnt, size_t *length_read);
 static int block_write(io_entity_t *entity, const uintptr_t buffer,
 		       size_t length, size_t *length_written);
 static int block_close(io_entity_t *entity);
@@ -44,8 +47,9 @@ static const io_dev_funcs_t block_dev_funcs = {
 	.type		= device_type_block,
 	.open		= block_open,
 	.seek		= block_seek,
-	.size		= NULL,
+	.size		= block_len,
 	.read		= block_read,
+	.readv		= block_readv,
 	.write		= block_write,
 	.close		= block_close,
 	.dev_init	= NULL,
@@ -167,6 +171,17 @@ static int block_seek(io_entity_t *entity, int mode, ssize_t offset)
 	return 0;
 }
 
+/* Return the size of the region opened */
+static int block_len(io_entity_t *entity, size_t *length)
+{
+	assert(entity->info != (uintptr_t)NULL);
+	assert(length != NULL);
+
+	*length = ((block_dev_state_t *)entity->info)->size;
+
+	return 0;
+}
+
 /*
  * This function allows the caller to read any number of bytes
  * from any position. It hides from the caller that the low level
@@ -342,6 +357,71 @@ static int block_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 	return 0;
 }
 
+/*
+ * Read into several buffers. When the low level driver supports it, the
+ * buffers which start on a block boundary of the device and are a multiple of
+ * the block size are read in a single transfer, straight into the buffers.
+ * The others go through the buffer of the device as for block_read().
+ */
+static int block_readv(io_entity_t *entity, const io_iovec_t *iov,
+		       unsigned int iovcnt, size_t *length_read)
+{
+	block_dev_state_t *cur;
+	io_block_ops_t *ops;
+	size_t block_size;
+	size_t request; /* number of bytes of the buffers gathered */
+	size_t nbytes;
+	size_t count;   /* number of bytes already read */
+	unsigned int i, n;
+	int result;
+
+	assert(entity->info != (uintptr_t)NULL);
+	assert(length_read != NULL);
+	cur = (block_dev_state_t *)entity->info;
+	ops = &(cur->dev_spec->ops);
+	block_size = cur->dev_spec->block_size;
+
+	count = 0;
+	for (i = 0; i < iovcnt; i += n) {
+		request = 0;
+		n = 0;
+		if ((ops->readv != NULL) &&
+		    ((cur->file_pos & (block_size - 1)) == 0)) {
+			while ((i + n < iovcnt) && (iov[i + n].length != 0) &&
+			       ((iov[i + n].length & (block_size - 1)) == 0)) {
+				/* The gathered buffers must fit in the region */
+				if (iov[i + n].length > (cur->size - request))
+					return -EINVAL;
+				request += iov[i + n].length;
+				n++;
+			}
+		}
+
+		if (n > 0) {
+			if (cur->file_pos > (cur->size - request))
+				return -EINVAL;
+			nbytes = ops->readv((cur->file_pos + cur->base) /
+					    block_size, &iov[i], n);
+			if (nbytes != request)
+				return -EIO;
+			cur->file_pos += nbytes;
+		} else {
+			n = 1;
+			if (iov[i].length == 0)
+				continue;
+			result = block_read(entity, iov[i].base, iov[i].length,
+					    &nbytes);
+			if (result != 0)
+				return result;
+		}
+
+		count += nbytes;
+	}
+	*length_read = count;
+
+	return 0;
+}
+
 /*
  * This function allows the caller to write any number of bytes
  * from any position. It hides from the caller that the low level
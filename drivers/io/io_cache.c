@@ -0,0 +1,674 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <io_cache.h>
+#include <io_driver.h>
+#include <io_storage.h>
+#include <platform_def.h>
+#include <string.h>
+#include <utils.h>
+
+/*
+ * Block cache over another IO device. The files of the backend device are
+ * cached in blocks of the file, identified by the specification the file was
+ * opened with, so the cached data survives the file being closed and opened
+ * again (e.g. the FIP driver opens its backend for each file and each read).
+ * The specifications must therefore be static and always describe the same
+ * data, or io_cache_invalidate() must be called when this isn't the case.
+ *
+ * - Blocks are replaced in FIFO order, so that a run of blocks read ahead is
+ *   stored contiguously and read from the backend in one go.
+ * - A miss on the block following the last block accessed, or on the first
+ *   block of the file, is considered sequential: up to 'readahead' more blocks
+ *   are read along with the missing one.
+ * - A read covering several whole blocks which are not cached is done directly
+ *   into the caller's buffer, so that loading an image doesn't evict the
+ *   metadata cached so far.
+ * - Files are only cached if the backend can tell their size; the others are
+ *   read directly from the backend. Writes go to the backend and invalidate the
+ *   blocks of the file.
+ * - Backends which can't seek, like io_fip, are read forward to the position
+ *   of a miss, after being reopened if the position is behind them.
+ */
+
+#ifndef MAX_IO_CACHE_DEVICES
+#define MAX_IO_CACHE_DEVICES	1
+#endif
+
+/* Maximum number of blocks of a cache device */
+#ifndef IO_CACHE_MAX_BLOCKS
+#define IO_CACHE_MAX_BLOCKS	32
+#endif
+
+typedef struct {
+	/* Specification of the file the block belongs to, 0 if free */
+	uintptr_t	file_spec;
+	size_t		index;
+	size_t		length;
+	/* Whether the block was read ahead and hasn't been used yet */
+	int		readahead;
+} cache_block_t;
+
+typedef struct {
+	const io_cache_dev_spec_t	*dev_spec;
+	cache_block_t			block[IO_CACHE_MAX_BLOCKS];
+	/* Next block to be replaced */
+	unsigned int			next;
+	io_cache_stats_t		stats;
+
+	/* State of the open file, only one file can be open at a time */
+	int				in_use;
+	int				cached;
+	int				seekable;
+	uintptr_t			file_spec;
+	uintptr_t			backend_handle;
+	size_t				backend_pos;
+	size_t				file_pos;
+	size_t				size;
+	/* Index of the block following the last block accessed */
+	size_t				next_index;
+} cache_dev_state_t;
+
+static int cache_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info);
+static int cache_open(io_dev_info_t *dev_info, const uintptr_t spec,
+		      io_entity_t *entity);
+static int cache_seek(io_entity_t *entity, int mode, ssize_t offset);
+static int cache_len(io_entity_t *entity, size_t *length);
+static int cache_read(io_entity_t *entity, uintptr_t buffer, size_t length,
+		      size_t *length_read);
+static int cache_write(io_entity_t *entity, const uintptr_t buffer,
+		       size_t length, size_t *length_written);
+static int cache_close(io_entity_t *entity);
+static int cache_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
+static int cache_dev_close(io_dev_info_t *dev_info);
+
+static const io_dev_connector_t cache_dev_connector = {
+	.dev_open	= cache_dev_open
+};
+
+/* Identify the device type as a virtual driver */
+static io_type_t device_type_cache(void)
+{
+	return IO_TYPE_CACHE;
+}
+
+static const io_dev_funcs_t cache_dev_funcs = {
+	.type		= device_type_cache,
+	.open		= cache_open,
+	.seek		= cache_seek,
+	.size		= cache_len,
+	.read		= cache_read,
+	.readv		= NULL,
+	.write		= cache_write,
+	.close		= cache_close,
+	.dev_init	= cache_dev_init,
+	.dev_close	= cache_dev_close,
+};
+
+static cache_dev_state_t state_pool[MAX_IO_CACHE_DEVICES];
+static io_dev_info_t dev_info_pool[MAX_IO_CACHE_DEVICES];
+
+/* Track number of allocated cache devices */
+static unsigned int cache_dev_count;
+
+/* Locate a cache state in the pool, specified by address */
+static int find_first_cache_state(const io_cache_dev_spec_t *dev_spec,
+				  unsigned int *index_out)
+{
+	int result = -ENOENT;
+	unsigned int index;
+
+	for (index = 0; index < (unsigned int)MAX_IO_CACHE_DEVICES; ++index) {
+		/* dev_spec is used as identifier since it's unique */
+		if (state_pool[index].dev_spec == dev_spec) {
+			result = 0;
+			*index_out = index;
+			break;
+		}
+	}
+	return result;
+}
+
+/* Allocate a device info from the pool and return a pointer to it */
+static int allocate_dev_info(io_dev_info_t **dev_info)
+{
+	int result = -ENOMEM;
+
+	assert(dev_info != NULL);
+
+	if (cache_dev_count < (unsigned int)MAX_IO_CACHE_DEVICES) {
+		unsigned int index = 0;
+
+		result = find_first_cache_state(NULL, &index);
+		assert(result == 0);
+		/* initialize dev_info */
+		dev_info_pool[index].funcs = &cache_dev_funcs;
+		dev_info_pool[index].info = (uintptr_t)&state_pool[index];
+		*dev_info = &dev_info_pool[index];
+		++cache_dev_count;
+	}
+
+	return result;
+}
+
+/* Release a device info to the pool */
+static int free_dev_info(io_dev_info_t *dev_info)
+{
+	int result;
+	unsigned int index = 0;
+	cache_dev_state_t *state;
+
+	assert(dev_info != NULL);
+
+	state = (cache_dev_state_t *)dev_info->info;
+	result = find_first_cache_state(state->dev_spec, &index);
+	if (result == 0) {
+		/* free if device info is valid */
+		zeromem(state, sizeof(cache_dev_state_t));
+		zeromem(dev_info, sizeof(io_dev_info_t));
+		--cache_dev_count;
+	}
+
+	return result;
+}
+
+static uintptr_t block_data(const cache_dev_state_t *cur, unsigned int slot)
+{
+	return cur->dev_spec->buffer + (slot * cur->dev_spec->block_size);
+}
+
+/* Return the slot of block 'index' of the open file, or -1 if not cached */
+static int lookup_block(const cache_dev_state_t *cur, size_t index)
+{
+	unsigned int i;
+
+	for (i = 0; i < cur->dev_spec->num_blocks; i++) {
+		if ((cur->block[i].file_spec == cur->file_spec) &&
+		    (cur->block[i].index == index))
+			return (int)i;
+	}
+
+	return -1;
+}
+
+static void invalidate_file(cache_dev_state_t *cur, uintptr_t file_spec)
+{
+	unsigned int i;
+
+	for (i = 0; i < cur->dev_spec->num_blocks; i++) {
+		if (cur->block[i].file_spec == file_spec)
+			cur->block[i].file_spec = 0;
+	}
+}
+
+/*
+ * Move the backend to offset 'pos' of the open file. Backends which can't seek
+ * (e.g. io_fip) are reopened if needed and read forward to 'pos', using the
+ * 'length' bytes at 'buffer' as scratch space.
+ */
+static int backend_set_pos(cache_dev_state_t *cur, size_t pos,
+			   uintptr_t buffer, size_t length)
+{
+	size_t chunk, bytes_read;
+	int result;
+
+	/* A previous reopen failed */
+	if (cur->backend_handle == 0U)
+		return -EIO;
+
+	if (pos == cur->backend_pos)
+		return 0;
+
+	if (cur->seekable != 0) {
+		result = io_seek(cur->backend_handle, IO_SEEK_SET, (ssize_t)pos);
+		if (result != 0)
+			return result;
+		cur->backend_pos = pos;
+		return 0;
+	}
+
+	if (pos < cur->backend_pos) {
+		result = io_close(cur->backend_handle);
+		cur->backend_handle = 0;
+		if (result == 0)
+			result = io_open(cur->dev_spec->backend_dev_handle,
+					 cur->file_spec, &cur->backend_handle);
+		if (result != 0) {
+			cur->backend_pos = (size_t)-1;
+			return result;
+		}
+		cur->backend_pos = 0;
+	}
+
+	assert(length != 0U);
+	while (cur->backend_pos < pos) {
+		chunk = pos - cur->backend_pos;
+		if (chunk > length)
+			chunk = length;
+		result = io_read(cur->backend_handle, buffer, chunk,
+				 &bytes_read);
+		if ((result != 0) || (bytes_read != chunk)) {
+			cur->backend_pos = (size_t)-1;
+			return (result != 0) ? result : -EIO;
+		}
+		cur->backend_pos += chunk;
+	}
+
+	return 0;
+}
+
+/*
+ * Read up to 'length' bytes at offset 'pos' of the open file from the backend.
+ * The number of bytes read may be smaller at the end of the file.
+ */
+static int backend_read_partial(cache_dev_state_t *cur, size_t pos,
+				uintptr_t buffer, size_t length,
+				size_t *length_read)
+{
+	int result;
+
+	result = backend_set_pos(cur, pos, buffer, length);
+	if (result == 0)
+		result = io_read(cur->backend_handle, buffer, length,
+				 length_read);
+	if (result != 0) {
+		WARN("io_cache: failed to read the backend (%i)\n", result);
+		/* The position of the backend is unknown */
+		cur->backend_pos = (size_t)-1;
+		return result;
+	}
+	cur->backend_pos += *length_read;
+
+	return 0;
+}
+
+/* Read 'length' bytes at offset 'pos' of the open file from the backend */
+static int backend_read(cache_dev_state_t *cur, size_t pos, uintptr_t buffer,
+			size_t length)
+{
+	size_t bytes_read;
+	int result;
+
+	result = backend_read_partial(cur, pos, buffer, length, &bytes_read);
+	if ((result == 0) && (bytes_read != length)) {
+		WARN("io_cache: short read of the backend\n");
+		result = -EIO;
+	}
+
+	return result;
+}
+
+/*
+ * Read block 'index' of the open file, which isn't cached, and possibly some of
+ * the following blocks. Returns the slot of the block or a negative error.
+ */
+static int fill_block(cache_dev_state_t *cur, size_t index)
+{
+	const io_cache_dev_spec_t *spec = cur->dev_spec;
+	size_t count = 1U, last, length, pos;
+	unsigned int slot, n;
+	int result;
+
+	if ((index == 0U) || (index == cur->next_index))
+		count += spec->readahead;
+
+	/* Stop at the end of the file, of the buffer or at a cached block */
+	last = (cur->size - 1U) / spec->block_size;
+	if (count > (last - index + 1U))
+		count = last - index + 1U;
+	if (cur->next >= spec->num_blocks)
+		cur->next = 0;
+	if (count > (spec->num_blocks - cur->next))
+		count = spec->num_blocks - cur->next;
+	for (n = 1; n < count; n++) {
+		if (lookup_block(cur, index + n) >= 0)
+			break;
+	}
+	count = n;
+
+	slot = cur->next;
+	for (n = 0; n < count; n++)
+		cur->block[slot + n].file_spec = 0;
+
+	pos = index * spec->block_size;
+	length = count * spec->block_size;
+	if (length > (cur->size - pos))
+		length = cur->size - pos;
+
+	result = backend_read(cur, pos, block_data(cur, slot), length);
+	if (result != 0)
+		return result;
+
+	for (n = 0; n < count; n++) {
+		cur->block[slot + n].file_spec = cur->file_spec;
+		cur->block[slot + n].index = index + n;
+		cur->block[slot + n].length =
+			(length > spec->block_size) ? spec->block_size : length;
+		cur->block[slot + n].readahead = (n != 0U);
+		length -= cur->block[slot + n].length;
+	}
+
+	cur->next = slot + count;
+	cur->stats.misses++;
+	cur->stats.readahead += count - 1U;
+
+	return (int)slot;
+}
+
+/* Open a connection to a cache device */
+static int cache_dev_open(const uintptr_t dev_spec, io_dev_info_t **dev_info)
+{
+	const io_cache_dev_spec_t *spec = (const io_cache_dev_spec_t *)dev_spec;
+	cache_dev_state_t *cur;
+	io_dev_info_t *info;
+	int result;
+
+	assert(dev_info != NULL);
+	assert(spec != NULL);
+	assert((spec->buffer != (uintptr_t)NULL) && (spec->block_size != 0U));
+	assert((spec->num_blocks != 0U) &&
+	       (spec->num_blocks <= IO_CACHE_MAX_BLOCKS));
+
+	result = allocate_dev_info(&info);
+	if (result != 0)
+		return -ENOMEM;
+
+	cur = (cache_dev_state_t *)info->info;
+	cur->dev_spec = spec;
+
+	*dev_info = info;
+
+	return 0;
+}
+
+/* Initialise the backend, the cached data is kept */
+static int cache_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
+{
+	cache_dev_state_t *cur = (cache_dev_state_t *)dev_info->info;
+
+	return io_dev_init(cur->dev_spec->backend_dev_handle, init_params);
+}
+
+/* Close a connection to a cache device */
+static int cache_dev_close(io_dev_info_t *dev_info)
+{
+	return free_dev_info(dev_info);
+}
+
+static int cache_open(io_dev_info_t *dev_info, const uintptr_t spec,
+		      io_entity_t *entity)
+{
+	cache_dev_state_t *cur;
+	int result;
+
+	assert((dev_info->info != (uintptr_t)NULL) &&
+	       (spec != (uintptr_t)NULL) &&
+	       (entity->info == (uintptr_t)NULL));
+
+	cur = (cache_dev_state_t *)dev_info->info;
+	if (cur->in_use != 0) {
+		WARN("io_cache: Only one open file at a time.\n");
+		return -ENOMEM;
+	}
+
+	result = io_open(cur->dev_spec->backend_dev_handle, spec,
+			 &cur->backend_handle);
+	if (result != 0)
+		return result;
+
+	result = io_size(cur->backend_handle, &cur->size);
+	cur->cached = (result == 0) && (cur->size != 0U);
+	if (cur->cached == 0)
+		cur->size = 0;
+	cur->seekable = (io_seek(cur->backend_handle, IO_SEEK_SET, 0) == 0);
+
+	cur->in_use = 1;
+	cur->file_spec = spec;
+	cur->backend_pos = 0;
+	cur->file_pos = 0;
+	cur->next_index = 0;
+
+	entity->info = (uintptr_t)cur;
+
+	return 0;
+}
+
+static int cache_seek(io_entity_t *entity, int mode, ssize_t offset)
+{
+	cache_dev_state_t *cur;
+	size_t pos;
+
+	assert(entity->info != (uintptr_t)NULL);
+
+	cur = (cache_dev_state_t *)entity->info;
+
+	switch (mode) {
+	case IO_SEEK_SET:
+		pos = (size_t)offset;
+		break;
+	case IO_SEEK_CUR:
+		pos = cur->file_pos + offset;
+		break;
+	case IO_SEEK_END:
+		if (cur->cached == 0)
+			return -EINVAL;
+		pos = cur->size + offset;
+		break;
+	default:
+		return -EINVAL;
+	}
+
+	if ((cur->cached != 0) && (pos > cur->size))
+		return -EINVAL;
+
+	cur->file_pos = pos;
+
+	return 0;
+}
+
+static int cache_len(io_entity_t *entity, size_t *length)
+{
+	cache_dev_state_t *cur;
+
+	assert(entity->info != (uintptr_t)NULL);
+
+	cur = (cache_dev_state_t *)entity->info;
+	if (cur->cached == 0)
+		return io_size(cur->backend_handle, length);
+
+	*length = cur->size;
+
+	return 0;
+}
+
+static int cache_read(io_entity_t *entity, uintptr_t buffer, size_t length,
+		      size_t *length_read)
+{
+	const io_cache_dev_spec_t *spec;
+	cache_dev_state_t *cur;
+	size_t left = length, index, offset, chunk, n;
+	int result, slot;
+
+	assert(entity->info != (uintptr_t)NULL);
+	assert(length_read != NULL);
+
+	cur = (cache_dev_state_t *)entity->info;
+	spec = cur->dev_spec;
+
+	if (cur->cached == 0) {
+		result = backend_read_partial(cur, cur->file_pos, buffer,
+					      length, length_read);
+		if (result != 0)
+			return result;
+		cur->file_pos += *length_read;
+		return 0;
+	}
+
+	if ((cur->file_pos > cur->size) || (length > (cur->size - cur->file_pos)))
+		return -EINVAL;
+
+	while (left != 0U) {
+		index = cur->file_pos / spec->block_size;
+		offset = cur->file_pos % spec->block_size;
+		slot = lookup_block(cur, index);
+
+		if (slot < 0) {
+			/* Read whole blocks which aren't cached directly */
+			n = 0;
+			if (offset == 0U) {
+				while ((((n + 1U) * spec->block_size) <= left) &&
+				       (lookup_block(cur, index + n) < 0))
+					n++;
+			}
+			if (n > 1U) {
+				chunk = n * spec->block_size;
+				result = backend_read(cur, cur->file_pos,
+						      buffer, chunk);
+				if (result != 0)
+					return result;
+				cur->stats.bypassed += n;
+				cur->next_index = index + n;
+				cur->file_pos += chunk;
+				buffer += chunk;
+				left -= chunk;
+				continue;
+			}
+
+			slot = fill_block(cur, index);
+			if (slot < 0)
+				return slot;
+		} else {
+			cur->stats.hits++;
+			if (cur->block[slot].readahead != 0) {
+				cur->stats.readahead_hits++;
+				cur->block[slot].readahead = 0;
+			}
+		}
+
+		chunk = cur->block[slot].length - offset;
+		if (chunk > left)
+			chunk = left;
+		memcpy((void *)buffer,
+		       (const void *)(block_data(cur, (unsigned int)slot) +
+				      offset), chunk);
+
+		cur->next_index = index + 1U;
+		cur->file_pos += chunk;
+		buffer += chunk;
+		left -= chunk;
+	}
+
+	*length_read = length;
+
+	return 0;
+}
+
+static int cache_write(io_entity_t *entity, const uintptr_t buffer,
+		       size_t length, size_t *length_written)
+{
+	cache_dev_state_t *cur;
+	int result;
+
+	assert(entity->info != (uintptr_t)NULL);
+
+	cur = (cache_dev_state_t *)entity->info;
+
+	invalidate_file(cur, cur->file_spec);
+
+	if (cur->backend_handle == 0U)
+		return -EIO;
+
+	if (cur->file_pos != cur->backend_pos) {
+		result = io_seek(cur->backend_handle, IO_SEEK_SET,
+				 (ssize_t)cur->file_pos);
+		if (result != 0)
+			return result;
+		cur->backend_pos = cur->file_pos;
+	}
+
+	result = io_write(cur->backend_handle, buffer, length, length_written);
+	if (result != 0) {
+		cur->backend_pos = (size_t)-1;
+		return result;
+	}
+
+	cur->backend_pos += *length_written;
+	cur->file_pos += *length_written;
+
+	return 0;
+}
+
+static int cache_close(io_entity_t *entity)
+{
+	cache_dev_state_t *cur;
+	int result;
+
+	assert(entity->info != (uintptr_t)NULL);
+
+	cur = (cache_dev_state_t *)entity->info;
+	result = (cur->backend_handle != 0U) ?
+		 io_close(cur->backend_handle) : 0;
+
+	cur->in_use = 0;
+	cur->backend_handle = 0;
+	entity->info = 0;
+
+	return result;
+}
+
+/* Exported functions */
+
+/* Register the cache driver with the IO abstraction */
+int register_io_dev_cache(const io_dev_connector_t **dev_con)
+{
+	int result;
+
+	assert(dev_con != NULL);
+
+	/*
+	 * Since dev_info isn't really used in io_register_device, always
+	 * use the same device info at here instead.
+	 */
+	result = io_register_device(&dev_info_pool[0]);
+	if (result == 0)
+		*dev_con = &cache_dev_connector;
+
+	return result;
+}
+
+/* Return the statistics of a cache device */
+int io_cache_get_stats(uintptr_t dev_handle, io_cache_stats_t *stats)
+{
+	const io_dev_info_t *dev = (const io_dev_info_t *)dev_handle;
+
+	assert(stats != NULL);
+
+	if ((dev == NULL) || (dev->funcs != &cache_dev_funcs))
+		return -EINVAL;
+
+	*stats = ((const cache_dev_state_t *)dev->info)->stats;
+
+	return 0;
+}
+
+/* Drop all the data cached by a cache device */
+int io_cache_invalidate(uintptr_t dev_handle)
+{
+	const io_dev_info_t *dev = (const io_dev_info_t *)dev_handle;
+	cache_dev_state_t *cur;
+
+	if ((dev == NULL) || (dev->funcs != &cache_dev_funcs))
+		return -EINVAL;
+
+	cur = (cache_dev_state_t *)dev->info;
+	zeromem(cur->block, sizeof(cur->block));
+	cur->next = 0;
+
+	return 0;
+}
@@ -46,6 +46,7 @@ static const io_dev_funcs_t dummy_dev_funcs = {
 	.seek = NULL,
 	.size = dummy_block_len,
 	.read = dummy_block_read,
+	.readv = NULL,
 	.write = NULL,
 	.close = dummy_block_close,
 	.dev_init = NULL,
@@ -58,6 +58,14 @@ static file_state_t current_file = {0};
 static uintptr_t backend_dev_handle;
 static uintptr_t backend_image_spec;
 
+/*
+ * Last entry found in the Table of Contents. Images are usually opened twice
+ * in a row, by the platform check of the image source and then to be loaded,
+ * so this saves the second search. Forgotten when the device is initialised
+ * again, as the FIP may have changed.
+ */
+static fip_toc_entry_t last_entry;
+
 static fip_dev_state_t state_pool[MAX_FIP_DEVICES];
 static io_dev_info_t dev_info_pool[MAX_FIP_DEVICES];
 
@@ -71,6 +79,8 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 static int fip_file_len(io_entity_t *entity, size_t *length);
 static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 			  size_t *length_read);
+static int fip_file_readv(io_entity_t *entity, const io_iovec_t *iov,
+			  unsigned int iovcnt, size_t *length_read);
 static int fip_file_close(io_entity_t *entity);
 static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params);
 static int fip_dev_close(io_dev_info_t *dev_info);
@@ -112,6 +122,7 @@ static const io_dev_funcs_t fip_dev_funcs = {
 	.seek = NULL,
 	.size = fip_file_len,
 	.read = fip_file_read,
+	.readv = fip_file_readv,
 	.write = NULL,
 	.close = fip_file_close,
 	.dev_init = fip_dev_init,
@@ -220,6 +231,8 @@ static int fip_dev_init(io_dev_info_t *dev_info, const uintptr_t init_params)
 	fip_toc_header_t header;
 	size_t bytes_read;
 
+	zeromem(&last_entry, sizeof(last_entry));
+
 	/* Obtain a reference to the image by querying the platform layer */
 	result = plat_get_image_source(image_id, &backend_dev_handle,
 				       &backend_image_spec);
@@ -264,6 +277,7 @@ static int fip_dev_close(io_dev_info_t *dev_info)
 	/* Clear the backend. */
 	backend_dev_handle = (uintptr_t)NULL;
 	backend_image_spec = (uintptr_t)NULL;
+	zeromem(&last_entry, sizeof(last_entry));
 
 	return free_dev_info(dev_info);
 }
@@ -293,6 +307,14 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		return -ENOMEM;
 	}
 
+	if ((last_entry.offset_address != 0) &&
+	    (compare_uuids(&last_entry.uuid, &uuid_spec->uuid) == 0)) {
+		current_file.entry = last_entry;
+		current_file.file_pos = 0;
+		entity->info = (uintptr_t)&current_file;
+		return 0;
+	}
+
 	/* Attempt to access the FIP image */
 	result = io_open(backend_dev_handle, backend_image_spec,
 			 &backend_handle);
@@ -335,6 +357,7 @@ static int fip_file_open(io_dev_info_t *dev_info, const uintptr_t spec,
 		 */
 		current_file.file_pos = 0;
 		entity->info = (uintptr_t)&current_file;
+		last_entry = current_file.entry;
 	} else {
 		/* Did not find the file in the FIP. */
 		current_file.entry.offset_address = 0;
@@ -416,6 +439,60 @@ static int fip_file_read(io_entity_t *entity, uintptr_t buffer, size_t length,
 }
 
 
+/*
+ * Read data from a file in package into several buffers, with a single access
+ * to the backend.
+ */
+static int fip_file_readv(io_entity_t *entity, const io_iovec_t *iov,
+			  unsigned int iovcnt, size_t *length_read)
+{
+	int result;
+	file_state_t *fp;
+	size_t file_offset;
+	size_t bytes_read;
+	uintptr_t backend_handle;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+	assert(entity->info != (uintptr_t)NULL);
+
+	/* Open the backend, attempt to access the blob image */
+	result = io_open(backend_dev_handle, backend_image_spec,
+			 &backend_handle);
+	if (result != 0) {
+		WARN("Failed to open FIP (%i)\n", result);
+		return -ENOENT;
+	}
+
+	fp = (file_state_t *)entity->info;
+
+	/* Seek to the position in the FIP where the payload lives */
+	file_offset = fp->entry.offset_address + fp->file_pos;
+	result = io_seek(backend_handle, IO_SEEK_SET, file_offset);
+	if (result != 0) {
+		WARN("fip_file_readv: failed to seek\n");
+		result = -ENOENT;
+		goto fip_file_readv_close;
+	}
+
+	result = io_readv(backend_handle, iov, iovcnt, &bytes_read);
+	if (result != 0) {
+		/* We cannot read our data. Fail. */
+		WARN("Failed to read payload (%i)\n", result);
+		result = -ENOENT;
+	} else {
+		/* Set caller length and new file position. */
+		*length_read = bytes_read;
+		fp->file_pos += bytes_read;
+	}
+
+ fip_file_readv_close:
+	io_close(backend_handle);
+
+	return result;
+}
+
+
 /* Close a file in package */
 static int fip_file_close(io_entity_t *entity)
 {
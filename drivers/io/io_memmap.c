@@ -4,8 +4,10 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <debug.h>
+#include <errno.h>
 #include <io_driver.h>
 #include <io_memmap.h>
 #include <io_storage.h>
@@ -29,6 +31,9 @@ typedef struct {
 
 static file_state_t current_file = {0};
 
+/* DMA engine registered by the platform, if any */
+static const io_memmap_dma_ops_t *dma_ops;
+
 /* Identify the device type as memmap */
 static io_type_t device_type_memmap(void)
 {
@@ -44,6 +49,8 @@ static int memmap_block_seek(io_entity_t *entity, int mode,
 static int memmap_block_len(io_entity_t *entity, size_t *length);
 static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 			     size_t length, size_t *length_read);
+static int memmap_block_readv(io_entity_t *entity, const io_iovec_t *iov,
+			      unsigned int iovcnt, size_t *length_read);
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written);
 static int memmap_block_close(io_entity_t *entity);
@@ -61,6 +68,7 @@ static const io_dev_funcs_t memmap_dev_funcs = {
 	.seek = memmap_block_seek,
 	.size = memmap_block_len,
 	.read = memmap_block_read,
+	.readv = memmap_block_readv,
 	.write = memmap_block_write,
 	.close = memmap_block_close,
 	.dev_init = NULL,
@@ -96,6 +104,59 @@ static int memmap_dev_close(io_dev_info_t *dev_info)
 }
 
 
+/*
+ * Copy data out of the memory mapped device. Large copies are offloaded to the
+ * DMA engine of the platform, if any, which is then polled until completion.
+ *
+ * Only the cache lines entirely within the destination are written by the DMA
+ * engine, since invalidating a line shared with other data would discard the
+ * writes of the CPU to it. The partial lines at both ends are copied by the CPU.
+ */
+static int memmap_copy(uintptr_t dst, uintptr_t src, size_t length)
+{
+	uintptr_t start, end;
+	size_t head;
+	int result;
+
+	start = round_up(dst, CACHE_WRITEBACK_GRANULE);
+	end = round_down(dst + length, CACHE_WRITEBACK_GRANULE);
+
+	if ((dma_ops == NULL) || (length < dma_ops->min_length) ||
+	    (end <= start)) {
+		memcpy((void *)dst, (void *)src, length);
+		return 0;
+	}
+
+	head = start - dst;
+	memcpy((void *)dst, (void *)src, head);
+	memcpy((void *)end, (void *)(src + (end - dst)), dst + length - end);
+
+	/* Write back the dirty lines which could overwrite the copied data */
+	flush_dcache_range(start, end - start);
+
+	result = dma_ops->start(start, src + head, end - start);
+	if (result != 0) {
+		VERBOSE("memmap: DMA unavailable (%i), using the CPU\n", result);
+		memcpy((void *)start, (void *)(src + head), end - start);
+		return 0;
+	}
+
+	do {
+		result = dma_ops->poll();
+	} while (result == -EBUSY);
+
+	/* Discard the lines fetched speculatively during the copy */
+	inv_dcache_range(start, end - start);
+
+	if (result != 0) {
+		WARN("memmap: DMA copy failed (%i)\n", result);
+		return -EIO;
+	}
+
+	return 0;
+}
+
+
 /* Open a file on the memmap device */
 static int memmap_block_open(io_dev_info_t *dev_info, const uintptr_t spec,
 			     io_entity_t *entity)
@@ -168,6 +229,7 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 {
 	file_state_t *fp;
 	size_t pos_after;
+	int result;
 
 	assert(entity != NULL);
 	assert(length_read != NULL);
@@ -178,7 +240,9 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 	pos_after = fp->file_pos + length;
 	assert((pos_after >= fp->file_pos) && (pos_after <= fp->size));
 
-	memcpy((void *)buffer, (void *)(fp->base + fp->file_pos), length);
+	result = memmap_copy(buffer, fp->base + fp->file_pos, length);
+	if (result != 0)
+		return result;
 
 	*length_read = length;
 
@@ -189,6 +253,43 @@ static int memmap_block_read(io_entity_t *entity, uintptr_t buffer,
 }
 
 
+/* Read data from a file on the memmap device into several buffers */
+static int memmap_block_readv(io_entity_t *entity, const io_iovec_t *iov,
+			      unsigned int iovcnt, size_t *length_read)
+{
+	file_state_t *fp;
+	size_t pos_after;
+	unsigned int i;
+	int result;
+
+	assert(entity != NULL);
+	assert(length_read != NULL);
+
+	fp = (file_state_t *) entity->info;
+
+	pos_after = fp->file_pos;
+	for (i = 0; i < iovcnt; i++) {
+		/* Check that file position is valid for this read operation */
+		if ((iov[i].length > fp->size) ||
+		    (pos_after > (fp->size - iov[i].length)))
+			return -EINVAL;
+
+		result = memmap_copy(iov[i].base, fp->base + pos_after,
+				     iov[i].length);
+		if (result != 0)
+			return result;
+		pos_after += iov[i].length;
+	}
+
+	*length_read = pos_after - fp->file_pos;
+
+	/* Set file position after read */
+	fp->file_pos = pos_after;
+
+	return 0;
+}
+
+
 /* Write data to a file on the memmap device */
 static int memmap_block_write(io_entity_t *entity, const uintptr_t buffer,
 			      size_t length, size_t *length_written)
@@ -244,3 +345,14 @@ int register_io_dev_memmap(const io_dev_connector_t **dev_con)
 
 	return result;
 }
+
+/*
+ * Offload the large copies to the DMA engine described by 'ops', or stop
+ * offloading them if it is NULL.
+ */
+void io_memmap_set_dma(const io_memmap_dma_ops_t *ops)
+{
+	assert((ops == NULL) || ((ops->start != NULL) && (ops->poll != NULL)));
+
+	dma_ops = ops;
+}
@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <io_multi_source.h>
+#include <stddef.h>
+#include <string.h>
+
+/*
+ * Selection of the source to load an image from, among several configured by
+ * the platform (e.g. a FIP in flash, a second FIP, semihosting). Loading is
+ * sequential, so the sources can't actually race. Instead, the time each source
+ * takes to find an image and its failures are recorded, and the sources are
+ * tried in order of preference:
+ *
+ * - A source which has never been tried is raced against the others: it is
+ *   checked even after another source has found the image, and the source
+ *   which was the quickest to find it is used.
+ * - The sources which failed more often than not come last.
+ * - The others are ordered by their mean check time.
+ *
+ * Ties keep the order of the sources given by the platform.
+ */
+
+/* "IOMS" */
+#define IO_MULTI_SOURCE_MAGIC		0x534d4f49U
+
+/* The statistics are halved once this many checks have been recorded */
+#define IO_MULTI_SOURCE_DECAY		256U
+
+static const io_source_get_t *io_sources;
+static unsigned int io_num_sources;
+static io_multi_source_stats_t *io_stats;
+
+static uint32_t stats_checksum(const io_multi_source_stats_t *stats)
+{
+	const uint32_t *word = (const uint32_t *)stats;
+	uint32_t sum = 0U;
+	unsigned int i;
+
+	for (i = 0; i < (offsetof(io_multi_source_stats_t, checksum) /
+			 sizeof(uint32_t)); i++)
+		sum = (sum << 1) + (sum >> 31) + word[i];
+
+	return ~sum;
+}
+
+static void stats_update(void)
+{
+	io_stats->checksum = stats_checksum(io_stats);
+	flush_dcache_range((uintptr_t)io_stats, sizeof(*io_stats));
+}
+
+static int source_is_failing(const io_source_stats_t *stats)
+{
+	return stats->errors > stats->hits;
+}
+
+static uint64_t source_mean_ticks(const io_source_stats_t *stats)
+{
+	return (stats->hits != 0U) ? (stats->ticks / stats->hits) : 0U;
+}
+
+/* Whether source 'a' should be tried before source 'b' */
+static int source_is_preferred(unsigned int a, unsigned int b)
+{
+	const io_source_stats_t *sa = &io_stats->source[a];
+	const io_source_stats_t *sb = &io_stats->source[b];
+
+	if (source_is_failing(sa) != source_is_failing(sb))
+		return source_is_failing(sb);
+
+	return source_mean_ticks(sa) < source_mean_ticks(sb);
+}
+
+static void source_record(unsigned int source, int result, uint64_t ticks)
+{
+	io_source_stats_t *stats = &io_stats->source[source];
+
+	if ((stats->hits + stats->errors) >= IO_MULTI_SOURCE_DECAY) {
+		stats->hits /= 2U;
+		stats->errors /= 2U;
+		stats->ticks /= 2U;
+	}
+
+	if (result == 0) {
+		stats->hits++;
+		stats->ticks += ticks;
+	} else {
+		stats->errors++;
+	}
+}
+
+/*
+ * Register the sources images can be loaded from, in default order of
+ * preference, and the statistics of these sources. The statistics are reset
+ * unless they are valid and were recorded for as many sources.
+ */
+void io_multi_source_init(const io_source_get_t *sources,
+			  unsigned int num_sources,
+			  io_multi_source_stats_t *stats)
+{
+	unsigned int i;
+
+	assert(sources != NULL);
+	assert((num_sources > 0U) && (num_sources <= IO_MULTI_SOURCE_MAX));
+	assert(stats != NULL);
+
+	io_sources = sources;
+	io_num_sources = num_sources;
+	io_stats = stats;
+
+	if ((stats->magic != IO_MULTI_SOURCE_MAGIC) ||
+	    (stats->num_sources != num_sources) ||
+	    (stats->checksum != stats_checksum(stats))) {
+		memset(stats, 0, sizeof(*stats));
+		stats->magic = IO_MULTI_SOURCE_MAGIC;
+		stats->num_sources = num_sources;
+		stats_update();
+	}
+
+	for (i = 0; i < num_sources; i++) {
+		VERBOSE("IO source %u: %u hits, %u errors, %llu ticks mean\n",
+			i, stats->source[i].hits, stats->source[i].errors,
+			(unsigned long long)source_mean_ticks(&stats->source[i]));
+	}
+}
+
+/*
+ * Return the device handle and specification to load an image from, using the
+ * preferred source which has it. Returns 0 on success, or the error of the last
+ * source tried.
+ */
+int io_multi_source_get(unsigned int image_id, uintptr_t *dev_handle,
+			uintptr_t *image_spec)
+{
+	unsigned int order[IO_MULTI_SOURCE_MAX];
+	uint64_t start, ticks, best_ticks = 0U;
+	uintptr_t handle, spec;
+	unsigned int i, j, src;
+	int result = -ENOENT, found = 0;
+
+	assert(io_stats != NULL);
+
+	for (i = 0; i < io_num_sources; i++) {
+		for (j = i; (j > 0U) && source_is_preferred(i, order[j - 1U]);
+		     j--)
+			order[j] = order[j - 1U];
+		order[j] = i;
+	}
+
+	for (i = 0; i < io_num_sources; i++) {
+		src = order[i];
+
+		/* Only race the sources which have never been tried */
+		if ((found != 0) && ((io_stats->source[src].hits +
+				      io_stats->source[src].errors) != 0U))
+			continue;
+
+		start = read_cntpct_el0();
+		result = io_sources[src](image_id, &handle, &spec);
+		ticks = read_cntpct_el0() - start;
+		source_record(src, result, ticks);
+
+		if ((result != 0) || ((found != 0) && (ticks >= best_ticks)))
+			continue;
+
+		VERBOSE("Image id=%u found in IO source %u\n", image_id, src);
+		*dev_handle = handle;
+		*image_spec = spec;
+		best_ticks = ticks;
+		found = 1;
+	}
+
+	stats_update();
+
+	return (found != 0) ? 0 : result;
+}
@@ -44,6 +44,7 @@ static const io_dev_funcs_t sh_dev_funcs = {
 	.seek = sh_file_seek,
 	.size = sh_file_len,
 	.read = sh_file_read,
+	.readv = NULL,
 	.write = sh_file_write,
 	.close = sh_file_close,
 	.dev_init = NULL,	/* NOP */
@@ -292,6 +292,51 @@ int io_read(uintptr_t handle,
 }
 
 
+/*
+ * Read data from an IO entity into several buffers, one after the other. The
+ * read stops early if the end of the entity is reached.
+ */
+int io_readv(uintptr_t handle,
+		const io_iovec_t *iov,
+		unsigned int iovcnt,
+		size_t *length_read)
+{
+	int result = -ENODEV;
+	unsigned int i;
+	size_t bytes_read;
+	assert(is_valid_entity(handle));
+	assert(((iov != NULL) || (iovcnt == 0)) && (length_read != NULL));
+
+	io_entity_t *entity = (io_entity_t *)handle;
+
+	io_dev_info_t *dev = entity->dev_handle;
+
+	if (dev->funcs->readv != NULL)
+		return dev->funcs->readv(entity, iov, iovcnt, length_read);
+
+	if (dev->funcs->read == NULL)
+		return result;
+
+	/* Read the buffers one at a time */
+	*length_read = 0;
+	for (i = 0; i < iovcnt; i++) {
+		if (iov[i].length == 0)
+			continue;
+
+		result = dev->funcs->read(entity, iov[i].base, iov[i].length,
+					  &bytes_read);
+		if (result != 0)
+			return result;
+
+		*length_read += bytes_read;
+		if (bytes_read < iov[i].length)
+			break;
+	}
+
+	return 0;
+}
+
+
 /* Write data to an IO entity */
 int io_write(uintptr_t handle,
 		const uintptr_t buffer,
@@ -5,17 +5,47 @@
  */
 
 #include <assert.h>
+#include <cassert.h>
 #include <debug.h>
+#include <errno.h>
 #include <gpt.h>
 #include <io_storage.h>
 #include <mbr.h>
 #include <partition.h>
 #include <platform.h>
+#include <stddef.h>
 #include <string.h>
+#include <utils.h>
+#include <utils_def.h>
+
+/*
+ * Size of the reads of the GPT partition entry array. As everywhere else in
+ * this driver, the logical blocks of the device are assumed to be
+ * PARTITION_BLOCK_SIZE bytes, so that these reads are 8 blocks. The reads need
+ * not be aligned to the blocks of the device though, as io_block takes care of
+ * partial blocks.
+ */
+#define GPT_ENTRIES_READ_SIZE	(8 * PARTITION_BLOCK_SIZE)
+
+/*
+ * Open addressing hash table of the partition names. Each slot holds the index
+ * of an entry in 'list' plus one, or 0 when it is free.
+ */
+#define PARTITION_INDEX_SIZE	(2 * PLAT_PARTITION_MAX_ENTRIES)
 
 static uint8_t mbr_sector[PARTITION_BLOCK_SIZE];
+static gpt_entry_t gpt_entries[GPT_ENTRIES_READ_SIZE / sizeof(gpt_entry_t)];
+static uint8_t name_index[PARTITION_INDEX_SIZE];
 partition_entry_list_t list;
 
+CASSERT(PLAT_PARTITION_MAX_ENTRIES < UINT8_MAX, assert_partition_index_size);
+CASSERT((GPT_ENTRIES_READ_SIZE % sizeof(gpt_entry_t)) == 0,
+	assert_gpt_entries_read_size);
+/* gpt_header_t is padded up to 96 bytes on AArch64 */
+CASSERT(GPT_HEADER_MIN_SIZE == (offsetof(gpt_header_t, part_crc) +
+				sizeof(((gpt_header_t *)0)->part_crc)),
+	assert_gpt_header_min_size);
+
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
 static void dump_entries(int num)
 {
@@ -37,6 +67,60 @@ static void dump_entries(int num)
 #define dump_entries(num)	((void)num)
 #endif
 
+/* CRC32 as used by the GPT, i.e. the IEEE 802.3 polynomial, 4 bits at a time */
+static uint32_t gpt_crc32(uint32_t crc, const uint8_t *buf, size_t size)
+{
+	static const uint32_t table[16] = {
+		0x00000000, 0x1db71064, 0x3b6e20c8, 0x26d930ac,
+		0x76dc4190, 0x6b6b51f4, 0x4db26158, 0x5005713c,
+		0xedb88320, 0xf00f9344, 0xd6d6a3e8, 0xcb61b38c,
+		0x9b64c2b0, 0x86d3d2d4, 0xa00ae278, 0xbdbdf21c
+	};
+	size_t i;
+
+	crc = ~crc;
+	for (i = 0; i < size; i++) {
+		crc ^= buf[i];
+		crc = (crc >> 4) ^ table[crc & 0xf];
+		crc = (crc >> 4) ^ table[crc & 0xf];
+	}
+	return ~crc;
+}
+
+/* FNV-1a hash of a partition name */
+static unsigned int name_hash(const char *name)
+{
+	uint32_t hash = 2166136261U;
+
+	while (*name != '\0') {
+		hash ^= (uint8_t)*name++;
+		hash *= 16777619U;
+	}
+	return hash % PARTITION_INDEX_SIZE;
+}
+
+/*
+ * Index the names of the partitions in 'list'. When several partitions have the
+ * same name, lookups return the first one.
+ */
+static void build_name_index(void)
+{
+	unsigned int slot;
+	int i;
+
+	for (i = 0; i < list.entry_count; i++) {
+		slot = name_hash(list.list[i].name);
+		while (name_index[slot] != 0) {
+			if (strcmp(list.list[i].name,
+				   list.list[name_index[slot] - 1].name) == 0)
+				break;
+			slot = (slot + 1) % PARTITION_INDEX_SIZE;
+		}
+		if (name_index[slot] == 0)
+			name_index[slot] = i + 1;
+	}
+}
+
 /*
  * Load the first sector that carries MBR header.
  * The MBR boot signature should be always valid whether it's MBR or GPT.
@@ -72,10 +156,12 @@ static int load_mbr_header(uintptr_t image_handle, mbr_entry_t *mbr_entry)
 }
 
 /*
- * Load GPT header and check the GPT signature.
- * If partiton numbers could be found, check & update it.
+ * Load GPT header, check the GPT signature and the CRC32 of the header.
+ * If partiton numbers could be found, check & update it. The number of entries
+ * in the partition entry array and its CRC32 are returned in 'num' and 'crc'.
  */
-static int load_gpt_header(uintptr_t image_handle)
+static int load_gpt_header(uintptr_t image_handle, unsigned int *num,
+			   uint32_t *crc)
 {
 	gpt_header_t header;
 	size_t bytes_read;
@@ -85,15 +171,32 @@ static int load_gpt_header(uintptr_t image_handle)
 	if (result != 0) {
 		return result;
 	}
-	result = io_read(image_handle, (uintptr_t)&header,
-			 sizeof(gpt_header_t), &bytes_read);
-	if ((result != 0) || (sizeof(gpt_header_t) != bytes_read)) {
-		return result;
+	result = io_read(image_handle, (uintptr_t)&mbr_sector,
+			 PARTITION_BLOCK_SIZE, &bytes_read);
+	if ((result != 0) || (bytes_read != PARTITION_BLOCK_SIZE)) {
+		return (result != 0) ? result : -EINVAL;
 	}
+	memcpy(&header, mbr_sector, sizeof(gpt_header_t));
 	if (memcmp(header.signature, GPT_SIGNATURE,
 		   sizeof(header.signature)) != 0) {
 		return -EINVAL;
 	}
+	if ((header.size < GPT_HEADER_MIN_SIZE) ||
+	    (header.size > PARTITION_BLOCK_SIZE) ||
+	    (header.part_size != sizeof(gpt_entry_t))) {
+		return -EINVAL;
+	}
+
+	/* The header CRC is computed with the CRC field itself zeroed */
+	memset(&mbr_sector[offsetof(gpt_header_t, header_crc)], 0,
+	       sizeof(header.header_crc));
+	if (gpt_crc32(0, mbr_sector, header.size) != header.header_crc) {
+		WARN("Invalid GPT header CRC\n");
+		return -EINVAL;
+	}
+
+	*num = header.list_num;
+	*crc = header.part_crc;
 
 	/* partition numbers can't exceed PLAT_PARTITION_MAX_ENTRIES */
 	list.entry_count = header.list_num;
@@ -103,40 +206,57 @@ static int load_gpt_header(uintptr_t image_handle)
 	return 0;
 }
 
-static int load_gpt_entry(uintptr_t image_handle, gpt_entry_t *entry)
+/*
+ * Read the 'num' entries of the partition entry array, GPT_ENTRIES_READ_SIZE
+ * bytes at a time, and check their CRC32 against 'crc'. Entries are parsed up
+ * to the first unused one, but the whole array is covered by the CRC.
+ */
+static int verify_partition_gpt(uintptr_t image_handle, unsigned int num,
+				uint32_t crc)
 {
-	size_t bytes_read;
+	size_t bytes_read, size;
+	unsigned int i, j, count;
+	uint32_t array_crc = 0;
+	int parsed = 0, done = 0;
 	int result;
 
-	assert(entry != NULL);
-	result = io_read(image_handle, (uintptr_t)entry, sizeof(gpt_entry_t),
-			 &bytes_read);
-	if (sizeof(gpt_entry_t) != bytes_read)
-		return -EINVAL;
-	return result;
-}
-
-static int verify_partition_gpt(uintptr_t image_handle)
-{
-	gpt_entry_t entry;
-	int result, i;
+	for (i = 0; i < num; i += count) {
+		count = MIN(num - i, (unsigned int)ARRAY_SIZE(gpt_entries));
+		size = count * sizeof(gpt_entry_t);
+		result = io_read(image_handle, (uintptr_t)gpt_entries, size,
+				 &bytes_read);
+		if ((result != 0) || (bytes_read != size)) {
+			return (result != 0) ? result : -EINVAL;
+		}
+		array_crc = gpt_crc32(array_crc, (uint8_t *)gpt_entries, size);
 
-	for (i = 0; i < list.entry_count; i++) {
-		result = load_gpt_entry(image_handle, &entry);
-		assert(result == 0);
-		result = parse_gpt_entry(&entry, &list.list[i]);
-		if (result != 0) {
-			break;
+		for (j = 0; (j < count) && !done; j++) {
+			if (parsed == list.entry_count) {
+				done = 1;
+				break;
+			}
+			result = parse_gpt_entry(&gpt_entries[j],
+						 &list.list[parsed]);
+			if (result != 0) {
+				done = 1;
+				break;
+			}
+			parsed++;
 		}
 	}
-	if (i == 0) {
+	if (array_crc != crc) {
+		WARN("Invalid GPT partition entry array CRC\n");
+		return -EINVAL;
+	}
+	if (parsed == 0) {
 		return -EINVAL;
 	}
 	/*
 	 * Only records the valid partition number that is loaded from
 	 * partition table.
 	 */
-	list.entry_count = i;
+	list.entry_count = parsed;
+	build_name_index();
 	dump_entries(list.entry_count);
 
 	return 0;
@@ -146,8 +266,12 @@ int load_partition_table(unsigned int image_id)
 {
 	uintptr_t dev_handle, image_handle, image_spec = 0;
 	mbr_entry_t mbr_entry;
+	unsigned int num;
+	uint32_t crc;
 	int result;
 
+	zeromem(name_index, sizeof(name_index));
+
 	result = plat_get_image_source(image_id, &dev_handle, &image_spec);
 	if (result != 0) {
 		WARN("Failed to obtain reference to image id=%u (%i)\n",
@@ -167,11 +291,14 @@ int load_partition_table(unsigned int image_id)
 		return result;
 	}
 	if (mbr_entry.type == PARTITION_TYPE_GPT) {
-		result = load_gpt_header(image_handle);
-		assert(result == 0);
+		result = load_gpt_header(image_handle, &num, &crc);
+		if (result != 0) {
+			WARN("Failed to read GPT header (%i)\n", result);
+			goto exit;
+		}
 		result = io_seek(image_handle, IO_SEEK_SET, GPT_ENTRY_OFFSET);
 		assert(result == 0);
-		result = verify_partition_gpt(image_handle);
+		result = verify_partition_gpt(image_handle, num, crc);
 	} else {
 		/* MBR type isn't supported yet. */
 		result = -EINVAL;
@@ -184,12 +311,15 @@ exit:
 
 const partition_entry_t *get_partition_entry(const char *name)
 {
-	int i;
+	unsigned int slot = name_hash(name);
+	const partition_entry_t *entry;
 
-	for (i = 0; i < list.entry_count; i++) {
-		if (strcmp(name, list.list[i].name) == 0) {
-			return &list.list[i];
+	while (name_index[slot] != 0) {
+		entry = &list.list[name_index[slot] - 1];
+		if (strcmp(name, entry->name) == 0) {
+			return entry;
 		}
+		slot = (slot + 1) % PARTITION_INDEX_SIZE;
 	}
 	return NULL;
 }
@@ -226,7 +226,7 @@ int fdt_rcc_read_uint32_array(const char *prop_name,
 		return -ENOENT;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
+	node = dt_node_offset_by_compatible(DT_RCC_CLK_COMPAT);
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -248,7 +248,7 @@ int fdt_rcc_subnode_offset(const char *name)
 		return -ENOENT;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
+	node = dt_node_offset_by_compatible(DT_RCC_CLK_COMPAT);
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -277,7 +277,7 @@ const uint32_t *fdt_rcc_read_prop(const char *prop_name, int *lenp)
 		return NULL;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_RCC_CLK_COMPAT);
+	node = dt_node_offset_by_compatible(DT_RCC_CLK_COMPAT);
 	if (node < 0) {
 		return NULL;
 	}
@@ -305,7 +305,7 @@ bool fdt_get_rcc_secure_status(void)
 		return false;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_RCC_COMPAT);
+	node = dt_node_offset_by_compatible(DT_RCC_COMPAT);
 	if (node < 0) {
 		return false;
 	}
@@ -328,7 +328,7 @@ uintptr_t fdt_get_stgen_base(void)
 		return 0;
 	}
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_STGEN_COMPAT);
+	node = dt_node_offset_by_compatible(DT_STGEN_COMPAT);
 	if (node < 0) {
 		return 0;
 	}
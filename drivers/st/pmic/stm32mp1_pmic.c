@@ -42,7 +42,7 @@ static uint32_t pmic_i2c_addr;
 
 static int dt_get_pmic_node(void *fdt)
 {
-	return fdt_node_offset_by_compatible(fdt, -1, "st,stpmu1");
+	return dt_node_offset_by_compatible("st,stpmu1");
 }
 
 bool dt_check_pmic(void)
@@ -7,6 +7,7 @@
 #ifndef __BL31_H__
 #define __BL31_H__
 
+#include <stddef.h>
 #include <stdint.h>
 
 /*******************************************************************************
@@ -20,5 +21,9 @@ void bl31_register_bl32_init(int32_t (*func)(void));
 void bl31_warm_entrypoint(void);
 void bl31_main(void);
 void bl31_lib_init(void);
+void bl31_ns_mem_lock_acquire(void);
+void bl31_ns_mem_lock_release(void);
+int bl31_map_ns_mem(uintptr_t base, size_t size);
+int bl31_unmap_ns_mem(uintptr_t base, size_t size);
 
 #endif /* __BL31_H__ */
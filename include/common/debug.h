@@ -70,14 +70,81 @@
 # define WARN(...)	no_tf_log(LOG_MARKER_WARNING __VA_ARGS__)
 #endif
 
+#if BINARY_LOG && defined(IMAGE_BL31)
+#include <binary_log.h>
+#include <types.h>
+
+/*
+ * In BL31, INFO() and VERBOSE() messages are recorded in a binary log instead
+ * of being printed, see tf_log_binary(). Their format string is placed in a
+ * section which is not loaded. Messages with more than BINARY_LOG_MAX_ARGS
+ * arguments are printed as usual.
+ */
+#define _TF_LOG_BIN_SEL(_0, _1, _2, _3, _4, _5, _6, _7, _8, _9, _10,	\
+			_11, _12, n, ...)	n
+#define _TF_LOG_BIN_NARGS(...)						\
+	_TF_LOG_BIN_SEL(_, ##__VA_ARGS__, FMT, FMT, FMT, FMT, FMT, FMT,	\
+			6, 5, 4, 3, 2, 1, 0)
+#define _TF_LOG_BIN_CAT(a, b)	a##b
+#define _TF_LOG_BIN_XCAT(a, b)	_TF_LOG_BIN_CAT(a, b)
+
+#define _TF_LOG_BIN_REC(level, fmt, nargs, ...)				\
+	do {								\
+		static const char _fmt[]				\
+			__section(BINARY_LOG_FMT_SECTION) __used = fmt;	\
+		tf_log_binary(_fmt, level, nargs,			\
+			      (const u_register_t []){ __VA_ARGS__ });	\
+	} while (0)
+
+#define _TF_LOG_BIN_C(a)	((u_register_t)(a))
+
+#define _TF_LOG_BIN_FMT(m, l, fmt, ...)	tf_log(m fmt, ##__VA_ARGS__)
+#define _TF_LOG_BIN_0(m, l, fmt)					\
+	_TF_LOG_BIN_REC(l, fmt, 0, 0)
+#define _TF_LOG_BIN_1(m, l, fmt, a)					\
+	_TF_LOG_BIN_REC(l, fmt, 1, _TF_LOG_BIN_C(a))
+#define _TF_LOG_BIN_2(m, l, fmt, a, b)					\
+	_TF_LOG_BIN_REC(l, fmt, 2, _TF_LOG_BIN_C(a), _TF_LOG_BIN_C(b))
+#define _TF_LOG_BIN_3(m, l, fmt, a, b, c)				\
+	_TF_LOG_BIN_REC(l, fmt, 3, _TF_LOG_BIN_C(a), _TF_LOG_BIN_C(b), \
+			_TF_LOG_BIN_C(c))
+#define _TF_LOG_BIN_4(m, l, fmt, a, b, c, d)				\
+	_TF_LOG_BIN_REC(l, fmt, 4, _TF_LOG_BIN_C(a), _TF_LOG_BIN_C(b), \
+			_TF_LOG_BIN_C(c), _TF_LOG_BIN_C(d))
+#define _TF_LOG_BIN_5(m, l, fmt, a, b, c, d, e)				\
+	_TF_LOG_BIN_REC(l, fmt, 5, _TF_LOG_BIN_C(a), _TF_LOG_BIN_C(b), \
+			_TF_LOG_BIN_C(c), _TF_LOG_BIN_C(d), _TF_LOG_BIN_C(e))
+#define _TF_LOG_BIN_6(m, l, fmt, a, b, c, d, e, f)			\
+	_TF_LOG_BIN_REC(l, fmt, 6, _TF_LOG_BIN_C(a), _TF_LOG_BIN_C(b), \
+			_TF_LOG_BIN_C(c), _TF_LOG_BIN_C(d), _TF_LOG_BIN_C(e), \
+			_TF_LOG_BIN_C(f))
+
+#define tf_log_bin(marker, level, fmt, ...)				\
+	do {								\
+		no_tf_log(marker fmt, ##__VA_ARGS__);			\
+		_TF_LOG_BIN_XCAT(_TF_LOG_BIN_,				\
+				 _TF_LOG_BIN_NARGS(__VA_ARGS__))	\
+			(marker, level, fmt, ##__VA_ARGS__);		\
+	} while (0)
+#endif /* BINARY_LOG && defined(IMAGE_BL31) */
+
 #if LOG_LEVEL >= LOG_LEVEL_INFO
-# define INFO(...)	tf_log(LOG_MARKER_INFO __VA_ARGS__)
+# if BINARY_LOG && defined(IMAGE_BL31)
+#  define INFO(...)	tf_log_bin(LOG_MARKER_INFO, LOG_LEVEL_INFO, __VA_ARGS__)
+# else
+#  define INFO(...)	tf_log(LOG_MARKER_INFO __VA_ARGS__)
+# endif
 #else
 # define INFO(...)	no_tf_log(LOG_MARKER_INFO __VA_ARGS__)
 #endif
 
 #if LOG_LEVEL >= LOG_LEVEL_VERBOSE
-# define VERBOSE(...)	tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
+# if BINARY_LOG && defined(IMAGE_BL31)
+#  define VERBOSE(...)	tf_log_bin(LOG_MARKER_VERBOSE, LOG_LEVEL_VERBOSE, \
+				   __VA_ARGS__)
+# else
+#  define VERBOSE(...)	tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
+# endif
 #else
 # define VERBOSE(...)	no_tf_log(LOG_MARKER_VERBOSE __VA_ARGS__)
 #endif
@@ -95,5 +162,19 @@ void tf_vprintf(const char *fmt, va_list args);
 void tf_string_print(const char *str);
 void tf_log_set_max_level(unsigned int log_level);
 
+#if BINARY_LOG && defined(IMAGE_BL31)
+void tf_log_binary(const char *fmt, unsigned int level, unsigned int nargs,
+		   const u_register_t *args);
+void tf_log_binary_init(void);
+#endif
+
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+/* Per-CPU buffering of the runtime console output of BL31 */
+int tf_log_ring_putc(int c);
+void tf_log_ring_flush(void);
+void tf_log_ring_stop(void);
+void tf_log_ring_enable(void);
+#endif
+
 #endif /* __ASSEMBLY__ */
 #endif /* __DEBUG_H__ */
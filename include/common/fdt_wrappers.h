@@ -9,11 +9,74 @@
 #ifndef __FDT_WRAPPERS__
 #define __FDT_WRAPPERS__
 
+#include <stddef.h>
+#include <stdint.h>
+
 /* Number of cells, given total length in bytes. Each cell is 4 bytes long */
 #define NCELLS(len) ((len) / 4)
 
+/* Number of hash buckets of an FDT index */
+#define FDTW_INDEX_BUCKETS	64
+
+/*
+ * Index of the nodes of a Device Tree Blob by compatible string and by phandle,
+ * built in a single pass over the blob by fdtw_index_init(). The entries are
+ * stored in an arena provided by the caller. The index remains valid as long as
+ * the blob is only modified in place.
+ */
+typedef struct fdtw_index_entry {
+	uint32_t	key;
+	int32_t		offset;
+	uint16_t	next;
+	uint16_t	type;
+} fdtw_index_entry_t;
+
+typedef struct fdtw_index {
+	const void		*dtb;
+	fdtw_index_entry_t	*entries;
+	unsigned int		num_entries;
+	unsigned int		max_entries;
+	uint16_t		buckets[FDTW_INDEX_BUCKETS];
+} fdtw_index_t;
+
+/* Operations of a batch of edits applied by fdtw_apply_edits() */
+#define FDTW_EDIT_SETPROP	0
+#define FDTW_EDIT_APPENDPROP	1
+#define FDTW_EDIT_ADD_SUBNODE	2
+
+/* Node added by the edit at index 'i' of the same batch */
+#define FDTW_EDIT_NEW_NODE(i)	(-2 - (int)(i))
+
+/*
+ * Edit of a batch applied by fdtw_apply_edits(). 'name' is the name of the
+ * property or of the subnode, and 'value' and 'len' the value of a property.
+ */
+typedef struct fdtw_edit {
+	unsigned int	op;
+	int		node;
+	const char	*name;
+	const void	*value;
+	int		len;
+
+	/* Private to fdtw_apply_edits() */
+	int		seq;
+	int		group;
+	int		nameoff;
+	int		total_len;
+	int		old_len;
+	int		old_offset;
+	int		new_name;
+} fdtw_edit_t;
+
 int fdtw_read_cells(const void *dtb, int node, const char *prop,
 		unsigned int cells, void *value);
 int fdtw_write_inplace_cells(void *dtb, int node, const char *prop,
 		unsigned int cells, void *value);
+int fdtw_index_init(fdtw_index_t *index, const void *dtb, void *arena,
+		size_t arena_size);
+int fdtw_node_offset_by_compatible(const fdtw_index_t *index,
+		const char *compatible);
+int fdtw_node_offset_by_phandle(const fdtw_index_t *index, uint32_t phandle);
+int fdtw_apply_edits(const void *dtb, void *out, size_t out_size,
+		fdtw_edit_t *edits, unsigned int num_edits);
 #endif /* __FDT_WRAPPERS__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -9,4 +9,9 @@
 
 void mbedtls_init(void);
 
+#if TF_MBEDTLS_HEAP_ARENA
+void mbedtls_heap_reset(void);
+void mbedtls_heap_print_stats(void);
+#endif
+
 #endif /* __MBEDTLS_COMMON_H__ */
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -48,7 +48,10 @@
 #define MBEDTLS_ERROR_C
 #define MBEDTLS_MD_C
 
+/* The arena allocator replaces the mbed TLS memory buffer allocator */
+#if !TF_MBEDTLS_HEAP_ARENA
 #define MBEDTLS_MEMORY_BUFFER_ALLOC_C
+#endif
 #define MBEDTLS_OID_C
 
 #define MBEDTLS_PK_C
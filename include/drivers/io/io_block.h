@@ -9,10 +9,14 @@
 
 #include <io_storage.h>
 
-/* block devices ops */
+/*
+ * block devices ops. 'readv' is optional, it reads consecutive blocks into
+ * several buffers, each a multiple of the block size, in a single transfer.
+ */
 typedef struct io_block_ops {
 	size_t	(*read)(int lba, uintptr_t buf, size_t size);
 	size_t	(*write)(int lba, const uintptr_t buf, size_t size);
+	size_t	(*readv)(int lba, const io_iovec_t *iov, unsigned int iovcnt);
 } io_block_ops_t;
 
 typedef struct io_block_dev_spec {
@@ -0,0 +1,45 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __IO_CACHE_H__
+#define __IO_CACHE_H__
+
+#include <io_storage.h>
+
+/*
+ * Specification of a cache device, which caches the files of another IO device
+ * (e.g. io_block, io_memmap or io_fip) in blocks. A file is opened on the cache
+ * device with the specification it would be opened with on the backend device.
+ */
+typedef struct io_cache_dev_spec {
+	/* Handle of the device whose files are cached */
+	uintptr_t	backend_dev_handle;
+	/* Memory holding the cached data, 'num_blocks' of 'block_size' bytes */
+	uintptr_t	buffer;
+	size_t		block_size;
+	unsigned int	num_blocks;
+	/* Number of blocks read ahead on sequential misses, 0 to disable */
+	unsigned int	readahead;
+} io_cache_dev_spec_t;
+
+typedef struct io_cache_stats {
+	/* Blocks found in and missing from the cache */
+	unsigned int	hits;
+	unsigned int	misses;
+	/* Blocks read ahead, and the ones which were then used */
+	unsigned int	readahead;
+	unsigned int	readahead_hits;
+	/* Blocks read directly into the caller's buffer */
+	unsigned int	bypassed;
+} io_cache_stats_t;
+
+struct io_dev_connector;
+
+int register_io_dev_cache(const struct io_dev_connector **dev_con);
+int io_cache_get_stats(uintptr_t dev_handle, io_cache_stats_t *stats);
+int io_cache_invalidate(uintptr_t dev_handle);
+
+#endif /* __IO_CACHE_H__ */
@@ -43,6 +43,8 @@ typedef struct io_dev_funcs {
 	int (*size)(io_entity_t *entity, size_t *length);
 	int (*read)(io_entity_t *entity, uintptr_t buffer, size_t length,
 			size_t *length_read);
+	int (*readv)(io_entity_t *entity, const io_iovec_t *iov,
+			unsigned int iovcnt, size_t *length_read);
 	int (*write)(io_entity_t *entity, const uintptr_t buffer,
 			size_t length, size_t *length_written);
 	int (*close)(io_entity_t *entity);
@@ -7,8 +7,26 @@
 #ifndef __IO_MEMMAP_H__
 #define __IO_MEMMAP_H__
 
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * DMA engine the memmap driver can offload its large copies to. 'start' starts
+ * a copy, and 'poll' returns 0 once it is complete, -EBUSY while it is in
+ * progress or another negative error code if it failed. The platform is free to
+ * do other work from 'poll'. The driver does the cache maintenance of the
+ * destination, which is always aligned to CACHE_WRITEBACK_GRANULE.
+ */
+typedef struct io_memmap_dma_ops {
+	int (*start)(uintptr_t dst, uintptr_t src, size_t length);
+	int (*poll)(void);
+	/* Copies shorter than this are done by the CPU */
+	size_t min_length;
+} io_memmap_dma_ops_t;
+
 struct io_dev_connector;
 
 int register_io_dev_memmap(const struct io_dev_connector **dev_con);
+void io_memmap_set_dma(const io_memmap_dma_ops_t *ops);
 
 #endif /* __IO_MEMMAP_H__ */
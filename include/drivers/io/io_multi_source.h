@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __IO_MULTI_SOURCE_H__
+#define __IO_MULTI_SOURCE_H__
+
+#include <stdint.h>
+
+/* Maximum number of sources an image can be loaded from */
+#define IO_MULTI_SOURCE_MAX		4
+
+/*
+ * Check whether an image can be loaded from a source and if so, return the
+ * device handle and specification to load it with. Returns 0 on success.
+ */
+typedef int (*io_source_get_t)(unsigned int image_id, uintptr_t *dev_handle,
+			       uintptr_t *image_spec);
+
+/* Statistics of the checks of a source */
+typedef struct io_source_stats {
+	/* Number of successful and failed checks */
+	uint32_t	hits;
+	uint32_t	errors;
+	/* Total time of the successful checks, in system counter ticks */
+	uint64_t	ticks;
+} io_source_stats_t;
+
+/*
+ * Statistics of all the sources. The platform may place them in memory which is
+ * preserved across resets to keep them across boots.
+ */
+typedef struct io_multi_source_stats {
+	uint32_t		magic;
+	uint32_t		num_sources;
+	io_source_stats_t	source[IO_MULTI_SOURCE_MAX];
+	uint32_t		checksum;
+	uint32_t		reserved;
+} io_multi_source_stats_t;
+
+void io_multi_source_init(const io_source_get_t *sources,
+			  unsigned int num_sources,
+			  io_multi_source_stats_t *stats);
+int io_multi_source_get(unsigned int image_id, uintptr_t *dev_handle,
+			uintptr_t *image_spec);
+
+#endif /* __IO_MULTI_SOURCE_H__ */
@@ -22,6 +22,7 @@ typedef enum {
 	IO_TYPE_DUMMY,
 	IO_TYPE_FIRMWARE_IMAGE_PACKAGE,
 	IO_TYPE_BLOCK,
+	IO_TYPE_CACHE,
 	IO_TYPE_MAX
 } io_type_t;
 
@@ -60,6 +61,12 @@ typedef struct io_block_spec {
 	size_t length;
 } io_block_spec_t;
 
+/* Buffer of a vectored read */
+typedef struct io_iovec {
+	uintptr_t base;
+	size_t length;
+} io_iovec_t;
+
 
 /* Access modes used when accessing data on a device */
 #define IO_MODE_INVALID (0)
@@ -93,6 +100,9 @@ int io_size(uintptr_t handle, size_t *length);
 int io_read(uintptr_t handle, uintptr_t buffer, size_t length,
 		size_t *length_read);
 
+int io_readv(uintptr_t handle, const io_iovec_t *iov, unsigned int iovcnt,
+		size_t *length_read);
+
 int io_write(uintptr_t handle, const uintptr_t buffer, size_t length,
 		size_t *length_written);
 
@@ -17,6 +17,9 @@
 
 #define GPT_SIGNATURE			"EFI PART"
 
+/* Size of the GPT header defined by UEFI, up to and including part_crc */
+#define GPT_HEADER_MIN_SIZE		92
+
 typedef struct gpt_entry {
 	unsigned char		type_uuid[GUID_LEN];
 	unsigned char		unique_uuid[GUID_LEN];
@@ -59,7 +59,7 @@
 #define CTX_RUNTIME_SP		U(0x10)
 #define CTX_SPSR_EL3		U(0x18)
 #define CTX_ELR_EL3		U(0x20)
-#define CTX_UNUSED		U(0x28)
+#define CTX_FPREGS_LIVE		U(0x28)	/* Only used with CTX_LAZY_FPREGS */
 #define CTX_EL3STATE_END	U(0x30)
 
 /*******************************************************************************
@@ -124,6 +124,27 @@
 #define CTX_SYSREGS_END		CTX_TIMER_SYSREGS_OFF
 #endif /* __NS_TIMER_SWITCH__ */
 
+/*
+ * Bit positions of the groups of EL1 system registers which can be saved and
+ * restored selectively with el1_sysregs_context_{save,restore}_partial(). The
+ * AArch32 and timer groups are only switched when the build includes them.
+ */
+#define CTX_EL1_SPSR_ELR_BIT		U(0)	/* SPSR_EL1, ELR_EL1 */
+#define CTX_EL1_SCTLR_ACTLR_BIT		U(1)	/* SCTLR_EL1, ACTLR_EL1 */
+#define CTX_EL1_CPACR_CSSELR_BIT	U(2)	/* CPACR_EL1, CSSELR_EL1 */
+#define CTX_EL1_SP_ESR_BIT		U(3)	/* SP_EL1, ESR_EL1 */
+#define CTX_EL1_TTBR_BIT		U(4)	/* TTBR0_EL1, TTBR1_EL1 */
+#define CTX_EL1_MAIR_BIT		U(5)	/* MAIR_EL1, AMAIR_EL1 */
+#define CTX_EL1_TCR_TPIDR_BIT		U(6)	/* TCR_EL1, TPIDR_EL1 */
+#define CTX_EL1_TPIDR_EL0_BIT		U(7)	/* TPIDR_EL0, TPIDRRO_EL0 */
+#define CTX_EL1_PAR_FAR_BIT		U(8)	/* PAR_EL1, FAR_EL1 */
+#define CTX_EL1_AFSR_BIT		U(9)	/* AFSR0_EL1, AFSR1_EL1 */
+#define CTX_EL1_CONTEXTIDR_VBAR_BIT	U(10)	/* CONTEXTIDR_EL1, VBAR_EL1 */
+#define CTX_EL1_PMCR_BIT		U(11)	/* PMCR_EL0 */
+#define CTX_EL1_AARCH32_BIT		U(12)	/* SPSR_{ABT,UND,IRQ,FIQ}, DACR32_EL2, IFSR32_EL2 */
+#define CTX_EL1_TIMER_BIT		U(13)	/* CNT{P,V}_{CTL,CVAL}_EL0, CNTKCTL_EL1 */
+#define CTX_EL1_ALL_REGS		U(0x3fff)
+
 /*******************************************************************************
  * Constants that allow assembler code to access members of and the 'fp_regs'
  * structure at their correct offsets.
@@ -332,6 +353,9 @@ CASSERT(CTX_CVE_2018_3639_OFFSET == __builtin_offsetof(cpu_context_t, cve_2018_3
  ******************************************************************************/
 void el1_sysregs_context_save(el1_sys_regs_t *regs);
 void el1_sysregs_context_restore(el1_sys_regs_t *regs);
+void el1_sysregs_context_save_partial(el1_sys_regs_t *regs, unsigned int groups);
+void el1_sysregs_context_restore_partial(el1_sys_regs_t *regs,
+					 unsigned int groups);
 #if CTX_INCLUDE_FPREGS
 void fpregs_context_save(fp_regs_t *regs);
 void fpregs_context_restore(fp_regs_t *regs);
@@ -38,6 +38,15 @@ void cm_prepare_el3_exit(uint32_t security_state);
 #ifndef AARCH32
 void cm_el1_sysregs_context_save(uint32_t security_state);
 void cm_el1_sysregs_context_restore(uint32_t security_state);
+void cm_el1_sysregs_context_save_partial(uint32_t security_state,
+					 unsigned int groups);
+void cm_el1_sysregs_context_restore_partial(uint32_t security_state,
+					    unsigned int groups);
+#if CTX_LAZY_FPREGS
+void cm_lazy_fpregs_handler(void);
+void cm_lazy_fpregs_flush(void);
+void cm_lazy_fpregs_invalidate(void);
+#endif
 void cm_set_elr_el3(uint32_t security_state, uintptr_t entrypoint);
 void cm_set_elr_spsr_el3(uint32_t security_state,
 			uintptr_t entrypoint, uint32_t spsr);
@@ -13,7 +13,9 @@
 #define RT_INSTR_EXIT_HW_LOW_PWR	3
 #define RT_INSTR_ENTER_CFLUSH		4
 #define RT_INSTR_EXIT_CFLUSH		5
-#define RT_INSTR_TOTAL_IDS		6
+#define RT_INSTR_ENTER_TSP_FAST_SMC	6
+#define RT_INSTR_EXIT_TSP_FAST_SMC	7
+#define RT_INSTR_TOTAL_IDS		8
 
 #ifndef __ASSEMBLY__
 PMF_DECLARE_CAPTURE_TIMESTAMP(rt_instr_svc)
@@ -19,6 +19,6 @@
 
 /* ARM SiP Service Calls version numbers */
 #define ARM_SIP_SVC_VERSION_MAJOR		0x0
-#define ARM_SIP_SVC_VERSION_MINOR		0x2
+#define ARM_SIP_SVC_VERSION_MINOR		0x3
 
 #endif /* __ARM_SIP_SVC_H__ */
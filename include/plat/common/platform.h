@@ -127,6 +127,8 @@ void plat_sdei_handle_masked_trigger(uint64_t mpidr, unsigned int intr);
 void plat_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags);
 
+int plat_is_ns_mem(uint64_t base, uint64_t size);
+
 /*
  * The following function is mandatory when the
  * firmware update feature is used.
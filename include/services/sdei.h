@@ -33,6 +33,43 @@
 #define SDEI_PRIVATE_RESET			0xC4000031
 #define SDEI_SHARED_RESET			0xC4000032
 
+/*
+ * Implementation defined calls using SiP function IDs, so as not to collide
+ * with future versions of the SDEI specification. They are dispatched by the
+ * SiP service of the platform through sdei_sip_smc_handler().
+ * SDEI_SIP_EVENT_BATCH registers, routes and enables a list of events in one
+ * call, and SDEI_SIP_EVENT_STATS_GET returns the dispatch statistics collected
+ * with SDEI_STATS.
+ */
+#define SDEI_SIP_EVENT_BATCH			0xC2000040
+#define SDEI_SIP_EVENT_STATS_GET		0xC2000041
+#define SDEI_SIP_NUM_SMC_CALLS			2
+
+/* SDEI_SIP_EVENT_BATCH operations, applied in this order to each event */
+#define SDEI_BATCH_OP_REGISTER		BIT(0)
+#define SDEI_BATCH_OP_ROUTING_SET	BIT(1)
+#define SDEI_BATCH_OP_ENABLE		BIT(2)
+#define SDEI_BATCH_OP_MASK		(SDEI_BATCH_OP_REGISTER | \
+					 SDEI_BATCH_OP_ROUTING_SET | \
+					 SDEI_BATCH_OP_ENABLE)
+
+/* Maximum number of event descriptors passed to SDEI_SIP_EVENT_BATCH */
+#define SDEI_BATCH_MAX_DESCS		256
+
+/* SDEI_SIP_EVENT_STATS_GET statistics */
+#define SDEI_STATS_DISPATCHED		0
+#define SDEI_STATS_DEFERRED		1
+#define SDEI_STATS_NESTED		2
+#define SDEI_STATS_TRIG_TO_DISP(_bin)	(0x100 + (_bin))
+#define SDEI_STATS_DISP_TO_COMP(_bin)	(0x200 + (_bin))
+
+/*
+ * Number of bins of the latency histograms. Bin n > 0 counts the latencies
+ * of [2^(n-1), 2^n) system counter ticks, bin 0 those of no tick, and the last
+ * bin also counts all longer latencies.
+ */
+#define SDEI_STATS_HIST_BINS		16
+
 /* SDEI_EVENT_REGISTER flags */
 #define SDEI_REGF_RM_ANY	0
 #define SDEI_REGF_RM_PE		1
@@ -102,6 +139,13 @@
 	((((_fid) & SDEI_FID_MASK) == SDEI_FID_VALUE) && \
 	 (((_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_64))
 
+/* The macros below are used to identify the SiP calls of the SDEI dispatcher */
+#define SDEI_SIP_FID_MASK	U(0xffe0)
+#define SDEI_SIP_FID_VALUE	U(0x40)
+#define is_sdei_sip_fid(_fid) \
+	((((_fid) & SDEI_SIP_FID_MASK) == SDEI_SIP_FID_VALUE) && \
+	 (((_fid >> FUNCID_CC_SHIFT) & FUNCID_CC_MASK) == SMC_64))
+
 #define SDEI_EVENT_MAP(_event, _intr, _flags) \
 	{ \
 		.ev_num = _event, \
@@ -129,6 +173,7 @@
  * declared. Only then would ARRAY_SIZE() yield a meaningful value.
  */
 #define REGISTER_SDEI_MAP(_private, _shared) \
+	_SDEI_DECLARE_STATS(_private, _shared) \
 	sdei_entry_t sdei_private_event_table \
 		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
 	sdei_entry_t sdei_shared_event_table[ARRAY_SIZE(_shared)]; \
@@ -143,8 +188,42 @@
 		}, \
 	}
 
+#if SDEI_STATS
+/* Per-CPU statistics of the dispatch of an event: see SDEI_SIP_EVENT_STATS_GET */
+typedef struct sdei_ev_stats {
+	uint32_t dispatched;
+	uint32_t deferred;
+	uint32_t nested;
+	uint32_t trig_to_disp[SDEI_STATS_HIST_BINS];
+	uint32_t disp_to_comp[SDEI_STATS_HIST_BINS];
+} sdei_ev_stats_t;
+
+# define _SDEI_DECLARE_STATS(_private, _shared) \
+	sdei_ev_stats_t sdei_private_event_stats \
+		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_private)]; \
+	sdei_ev_stats_t sdei_shared_event_stats \
+		[PLATFORM_CORE_COUNT * ARRAY_SIZE(_shared)];
+#else
+# define _SDEI_DECLARE_STATS(_private, _shared)
+#endif
+
 typedef uint8_t sdei_state_t;
 
+/*
+ * Event descriptor passed to SDEI_SIP_EVENT_BATCH, in Non-secure memory. The
+ * fields match the arguments of SDEI_EVENT_REGISTER and SDEI_EVENT_ROUTING_SET.
+ * If an operation fails for the event, 'result' is written back with its
+ * return value.
+ */
+typedef struct sdei_batch_desc {
+	int64_t ev_num;
+	uint64_t ep;
+	uint64_t arg;
+	uint64_t flags;
+	uint64_t affinity;
+	int64_t result;
+} sdei_batch_desc_t;
+
 /* Runtime data of SDEI event */
 typedef struct sdei_entry {
 	uint64_t ep;		/* Entry point */
@@ -180,6 +259,16 @@ uint64_t sdei_smc_handler(uint32_t smc_fid,
 		void *handle,
 		uint64_t flags);
 
+/* Handler to be called by the SiP service for the SiP calls of SDEI */
+uint64_t sdei_sip_smc_handler(uint32_t smc_fid,
+		uint64_t x1,
+		uint64_t x2,
+		uint64_t x3,
+		uint64_t x4,
+		void *cookie,
+		void *handle,
+		uint64_t flags);
+
 void sdei_init(void);
 
 /* Public API to dispatch an event to Normal world */
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#ifndef __BINARY_LOG_H__
+#define __BINARY_LOG_H__
+
+#include <stdint.h>
+
+/*
+ * Layout of the binary log of BL31, shared with the host decoder. The log
+ * starts with a header, followed by one ring of records per CPU. Records are
+ * written in the ring of a CPU in order, the next one at index 'seq' modulo
+ * the number of records per CPU.
+ */
+
+/* "TFBINLOG" read as a little-endian 64-bit value */
+#define BINARY_LOG_MAGIC		0x474f4c4e49424654ULL
+#define BINARY_LOG_VERSION		1
+
+/* Name of the section holding the format strings, which is not loaded */
+#define BINARY_LOG_FMT_SECTION		".tf_log_fmt"
+
+#define BINARY_LOG_MAX_ARGS		6
+
+/* Fields of the 'info' word of a record */
+#define BINARY_LOG_FMT_SHIFT		0
+#define BINARY_LOG_FMT_MASK		0xffffffffULL
+#define BINARY_LOG_LEVEL_SHIFT		32
+#define BINARY_LOG_LEVEL_MASK		0xffULL
+#define BINARY_LOG_NARGS_SHIFT		40
+#define BINARY_LOG_NARGS_MASK		0xffULL
+
+typedef struct binary_log_header {
+	uint64_t magic;
+	uint32_t version;
+	/* Number of per-CPU rings following the header */
+	uint32_t cpu_count;
+	/* Number of records in each ring */
+	uint32_t records;
+	uint32_t reserved;
+} binary_log_header_t;
+
+typedef struct binary_log_record {
+	/* Offset of the format string in its section, level and argument count */
+	uint64_t info;
+	/* System counter value when the record was written */
+	uint64_t timestamp;
+	uint64_t args[BINARY_LOG_MAX_ARGS];
+} binary_log_record_t;
+
+typedef struct binary_log_ring {
+	/* Number of records written to the ring so far */
+	uint64_t seq;
+	uint64_t reserved[7];
+	binary_log_record_t record[];
+} binary_log_ring_t;
+
+#endif /* __BINARY_LOG_H__ */
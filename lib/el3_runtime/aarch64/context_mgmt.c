@@ -447,7 +447,7 @@ void cm_prepare_el3_exit(uint32_t security_state)
 }
 
 /*******************************************************************************
- * The next four functions are used by runtime services to save and restore
+ * The next six functions are used by runtime services to save and restore
  * EL1 context on the 'cpu_context' structure for the specified security
  * state.
  ******************************************************************************/
@@ -468,6 +468,30 @@ void cm_el1_sysregs_context_save(uint32_t security_state)
 #endif
 }
 
+/*
+ * The partial variants only switch the groups of registers (CTX_EL1_*_BIT)
+ * set in 'groups'. They are meant for world switches where the other world
+ * is known not to modify the remaining EL1 registers, which are then left
+ * shared between both security states.
+ */
+void cm_el1_sysregs_context_save_partial(uint32_t security_state,
+					 unsigned int groups)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+
+	el1_sysregs_context_save_partial(get_sysregs_ctx(ctx), groups);
+
+#if IMAGE_BL31
+	if (security_state == SECURE)
+		PUBLISH_EVENT(cm_exited_secure_world);
+	else
+		PUBLISH_EVENT(cm_exited_normal_world);
+#endif
+}
+
 void cm_el1_sysregs_context_restore(uint32_t security_state)
 {
 	cpu_context_t *ctx;
@@ -485,6 +509,24 @@ void cm_el1_sysregs_context_restore(uint32_t security_state)
 #endif
 }
 
+void cm_el1_sysregs_context_restore_partial(uint32_t security_state,
+					    unsigned int groups)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(security_state);
+	assert(ctx);
+
+	el1_sysregs_context_restore_partial(get_sysregs_ctx(ctx), groups);
+
+#if IMAGE_BL31
+	if (security_state == SECURE)
+		PUBLISH_EVENT(cm_entering_secure_world);
+	else
+		PUBLISH_EVENT(cm_entering_normal_world);
+#endif
+}
+
 /*******************************************************************************
  * This function populates ELR_EL3 member of 'cpu_context' pertaining to the
  * given security state with the given entrypoint
@@ -0,0 +1,150 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch.h>
+#include <arch_helpers.h>
+#include <assert.h>
+#include <context.h>
+#include <context_mgmt.h>
+#include <pubsub_events.h>
+
+/*
+ * Lazy switching of the FP/SIMD registers between the Secure and Non-secure
+ * worlds. The CTX_FPREGS_LIVE flag in the EL3 state of a 'cpu_context'
+ * records whether that context currently owns the FP/SIMD registers of this
+ * CPU. When a world without ownership is entered, CPTR_EL3.TFP is set so that
+ * its first FP/SIMD access traps to EL3, where the registers are swapped.
+ *
+ * The following invariant is maintained: whenever CPTR_EL3.TFP is clear, the
+ * world running at a lower EL owns the FP/SIMD registers.
+ */
+
+static cpu_context_t *lazy_fpregs_owner(void)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(NON_SECURE);
+	if ((ctx != NULL) &&
+	    (read_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE) != 0U))
+		return ctx;
+
+	ctx = cm_get_context(SECURE);
+	if ((ctx != NULL) &&
+	    (read_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE) != 0U))
+		return ctx;
+
+	return NULL;
+}
+
+static void lazy_fpregs_set_trap(int trap)
+{
+	u_register_t cptr = read_cptr_el3();
+
+	if (trap != 0)
+		cptr |= TFP_BIT;
+	else
+		cptr &= ~TFP_BIT;
+
+	write_cptr_el3(cptr);
+	isb();
+}
+
+/*******************************************************************************
+ * Handler for a lower EL FP/SIMD access trapped by CPTR_EL3.TFP. It saves the
+ * FP context of the previous owner, if any, loads the one of the world which
+ * trapped and lets the trapped instruction run again.
+ ******************************************************************************/
+void cm_lazy_fpregs_handler(void)
+{
+	cpu_context_t *ctx, *owner;
+	uint32_t security_state;
+
+	security_state = ((read_scr_el3() & SCR_NS_BIT) != 0U) ?
+			 NON_SECURE : SECURE;
+	ctx = cm_get_context(security_state);
+	assert(ctx != NULL);
+
+	/* EL3 itself needs access to the registers to switch them */
+	lazy_fpregs_set_trap(0);
+
+	owner = lazy_fpregs_owner();
+	if (owner == ctx)
+		return;
+
+	if (owner != NULL) {
+		fpregs_context_save(get_fpregs_ctx(owner));
+		write_ctx_reg(get_el3state_ctx(owner), CTX_FPREGS_LIVE, 0);
+	}
+
+	fpregs_context_restore(get_fpregs_ctx(ctx));
+	write_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE, 1);
+}
+
+/*
+ * On entry to a world, only allow FP/SIMD accesses if it owns the registers.
+ */
+static void *lazy_fpregs_enter_world(uint32_t security_state)
+{
+	cpu_context_t *ctx = cm_get_context(security_state);
+
+	assert(ctx != NULL);
+	lazy_fpregs_set_trap(
+		read_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE) == 0U);
+
+	return NULL;
+}
+
+static void *lazy_fpregs_enter_secure(const void *arg)
+{
+	return lazy_fpregs_enter_world(SECURE);
+}
+
+static void *lazy_fpregs_enter_normal(const void *arg)
+{
+	return lazy_fpregs_enter_world(NON_SECURE);
+}
+
+/*******************************************************************************
+ * The FP/SIMD registers are lost when the CPU powers down. Save the state of
+ * the owner beforehand, so that it is reloaded on its next access. This must
+ * run after the Secure Payload Dispatcher power down hooks, which may enter
+ * the secure world and change the owner.
+ ******************************************************************************/
+void cm_lazy_fpregs_flush(void)
+{
+	cpu_context_t *owner = lazy_fpregs_owner();
+
+	if (owner != NULL) {
+		lazy_fpregs_set_trap(0);
+		fpregs_context_save(get_fpregs_ctx(owner));
+		write_ctx_reg(get_el3state_ctx(owner), CTX_FPREGS_LIVE, 0);
+	}
+
+	lazy_fpregs_set_trap(1);
+}
+
+/*******************************************************************************
+ * After power up, no context owns the FP/SIMD registers anymore. This must
+ * run before the Secure Payload Dispatcher power up hooks, which may enter
+ * the secure world.
+ ******************************************************************************/
+void cm_lazy_fpregs_invalidate(void)
+{
+	cpu_context_t *ctx;
+
+	ctx = cm_get_context(NON_SECURE);
+	if (ctx != NULL)
+		write_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE, 0);
+
+	ctx = cm_get_context(SECURE);
+	if (ctx != NULL)
+		write_ctx_reg(get_el3state_ctx(ctx), CTX_FPREGS_LIVE, 0);
+
+	lazy_fpregs_set_trap(1);
+}
+
+SUBSCRIBE_TO_EVENT(cm_entering_secure_world, lazy_fpregs_enter_secure);
+SUBSCRIBE_TO_EVENT(cm_entering_normal_world, lazy_fpregs_enter_normal);
@@ -1022,6 +1022,19 @@ int psci_get_suspend_afflvl(void)
  ******************************************************************************/
 void psci_do_pwrdown_sequence(unsigned int power_level)
 {
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+	/* Output the console messages buffered before the CPU goes idle */
+	tf_log_ring_flush();
+#endif
+
+#if CTX_LAZY_FPREGS
+	/*
+	 * Save the FP/SIMD registers of their owner, now that the Secure
+	 * Payload Dispatcher power down hooks have run.
+	 */
+	cm_lazy_fpregs_flush();
+#endif
+
 #if HW_ASSISTED_COHERENCY
 	/*
 	 * With hardware-assisted coherency, the CPU drivers only initiate the
@@ -186,6 +186,11 @@ void psci_cpu_on_finish(int cpu_idx, const psci_power_state_t *state_info)
 	 */
 	psci_arch_setup();
 
+#if CTX_LAZY_FPREGS
+	/* The FP/SIMD registers have not been loaded since power up */
+	cm_lazy_fpregs_invalidate();
+#endif
+
 	/*
 	 * Lock the CPU spin lock to make sure that the context initialization
 	 * is done. Since the lock is only used in this function to create
@@ -297,6 +297,11 @@ void psci_cpu_suspend_finish(int cpu_idx, const psci_power_state_t *state_info)
 	counter_freq = plat_get_syscnt_freq2();
 	write_cntfrq_el0(counter_freq);
 
+#if CTX_LAZY_FPREGS
+	/* The FP/SIMD registers have not been loaded since power up */
+	cm_lazy_fpregs_invalidate();
+#endif
+
 	/*
 	 * Call the cpu suspend finish handler registered by the Secure Payload
 	 * Dispatcher to let it do any bookeeping. If the handler encounters an
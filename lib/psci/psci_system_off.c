@@ -23,6 +23,9 @@ void __dead2 psci_system_off(void)
 		psci_spd_pm->svc_system_off();
 	}
 
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+	tf_log_ring_stop();
+#endif
 	(void) console_flush();
 
 	/* Call the platform specific hook */
@@ -42,6 +45,9 @@ void __dead2 psci_system_reset(void)
 		psci_spd_pm->svc_system_reset();
 	}
 
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+	tf_log_ring_stop();
+#endif
 	(void) console_flush();
 
 	/* Call the platform specific hook */
@@ -75,6 +81,9 @@ u_register_t psci_system_reset2(uint32_t reset_type, u_register_t cookie)
 	if ((psci_spd_pm != NULL) && (psci_spd_pm->svc_system_reset != NULL)) {
 		psci_spd_pm->svc_system_reset();
 	}
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+	tf_log_ring_stop();
+#endif
 	(void) console_flush();
 
 	return (u_register_t)
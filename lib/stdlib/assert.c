@@ -17,6 +17,9 @@
 #if PLAT_LOG_LEVEL_ASSERT >= LOG_LEVEL_VERBOSE
 void __assert(const char *file, unsigned int line, const char *assertion)
 {
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+	tf_log_ring_stop();
+#endif
 	tf_printf("ASSERT: %s:%d:%s\n", file, line, assertion);
 	console_flush();
 	plat_panic_handler();
@@ -24,6 +27,9 @@ void __assert(const char *file, unsigned int line, const char *assertion)
 #elif PLAT_LOG_LEVEL_ASSERT >= LOG_LEVEL_INFO
 void __assert(const char *file, unsigned int line)
 {
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+	tf_log_ring_stop();
+#endif
 	tf_printf("ASSERT: %s:%d\n", file, line);
 	console_flush();
 	plat_panic_handler();
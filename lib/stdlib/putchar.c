@@ -6,6 +6,7 @@
 
 #include <stdio.h>
 #include <console.h>
+#include <debug.h>
 
 /* Putchar() should either return the character printed or EOF in case of error.
  * Our current console_putc() function assumes success and returns the
@@ -15,6 +16,12 @@
 int putchar(int c)
 {
 	int res;
+
+#if CONSOLE_LOG_RING && defined(IMAGE_BL31)
+	if (tf_log_ring_putc((unsigned char)c) == 0)
+		return c;
+#endif
+
 	if (console_putc((unsigned char)c) >= 0)
 		res = c;
 	else
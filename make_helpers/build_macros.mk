@@ -170,6 +170,59 @@ check_$(1):
 	$$(if $(wildcard $(value $(_V))),,$$(error '$(_V)=$(value $(_V))' was specified, but '$(value $(_V))' does not exist))
 endef
 
+# CONTENT_STAMP records a host tool command line, together with the SHA-256 of
+# every file it names, in a stamp file. The stamp is only rewritten when this
+# content changes, so targets depending on it are regenerated when an input
+# changes rather than every time it is rebuilt or touched. It must be run from
+# a recipe which is always executed (i.e. depending on FORCE).
+#   $(1) = stamp file
+#   $(2) = tool command line
+#   $(3) = patterns of tool outputs to leave out of the stamp (optional)
+define CONTENT_STAMP
+	${Q}for w in $(filter-out $(3),$(2)); do				\
+		f=$${w##*file=};					\
+		if [ -f "$$f" ]; then					\
+			h=`sha256sum < "$$f" | cut -d' ' -f1`;		\
+		else							\
+			h=-;						\
+		fi;							\
+		printf '%s %s\n' "$$h" "$$w";				\
+	done > $(1).tmp
+	${Q}if cmp -s $(1).tmp $(1); then				\
+		rm -f $(1).tmp;						\
+	else								\
+		mv -f $(1).tmp $(1);					\
+	fi
+endef
+
+# FIP_PACKAGE builds a FIP from the fiptool arguments recorded by CONTENT_STAMP.
+# When the FIP was previously packaged from the same set of options and files,
+# only the payloads whose content has changed are replaced in place. Otherwise,
+# or if the in-place update fails, the FIP is created from scratch.
+#   $(1) = FIP file
+#   $(2) = fiptool arguments
+#   $(3) = stamp file
+define FIP_PACKAGE
+	${Q}if [ -f $(1) ] && [ -f $(3).packed ] &&			\
+	    [ "`cut -d' ' -f2 $(3)`" = "`cut -d' ' -f2 $(3).packed`" ]; then \
+		changed=`grep -vxFf $(3).packed $(3) | cut -d' ' -f2`;	\
+		args=; set -- $(2);					\
+		while [ $$# -gt 1 ]; do					\
+			if [ ! -f "$$2" ] ||				\
+			    echo "$$changed" | grep -qxF -- "$$2"; then	\
+				args="$$args $$1 $$2";			\
+			fi;						\
+			shift 2;					\
+		done;							\
+		echo "  FIP     update$$args";				\
+		${FIPTOOL} update --in-place $$args $(1) ||		\
+			${FIPTOOL} create $(2) $(1);			\
+	else								\
+		${FIPTOOL} create $(2) $(1);				\
+	fi
+	${Q}cp -f $(3) $(3).packed
+endef
+
 ################################################################################
 # Generic image processing filters
 ################################################################################
@@ -34,10 +34,18 @@ BL2_AT_EL3			:= 0
 # when BL2_AT_EL3 is 1.
 BL2_IN_XIP_MEM			:= 0
 
+# Record the INFO and VERBOSE messages of BL31 in a binary log, to be decoded on
+# the host, instead of printing them
+BINARY_LOG			:= 0
+
 # By default, consider that the platform may release several CPUs out of reset.
 # The platform Makefile is free to override this value.
 COLD_BOOT_SINGLE_CPU		:= 0
 
+# Buffer the runtime console output of BL31 in per-CPU rings instead of
+# printing it synchronously
+CONSOLE_LOG_RING		:= 0
+
 # Flag to compile in coreboot support code. Exclude by default. The coreboot
 # Makefile system will set this when compiling TF as part of a coreboot image.
 COREBOOT			:= 0
@@ -52,6 +60,9 @@ CTX_INCLUDE_AARCH32_REGS	:= 1
 # Include FP registers in cpu context
 CTX_INCLUDE_FPREGS		:= 0
 
+# Switch the FP registers between worlds on their first use only
+CTX_LAZY_FPREGS			:= 0
+
 # Debug build
 DEBUG				:= 0
 
@@ -99,6 +110,10 @@ GENERATE_COT			:= 0
 # default, they are for Secure EL1.
 GICV2_G0_FOR_EL3		:= 0
 
+# Only write back the GICv3 Distributor registers which changed while the system
+# was suspended, when the Distributor kept its state. Disabled by default.
+GICV3_DIST_RESTORE_DIRTY	:= 0
+
 # Route External Aborts to EL3. Disabled by default; External Aborts are handled
 # by lower ELs.
 HANDLE_EA_EL3_FIRST		:= 0
@@ -107,6 +122,13 @@ HANDLE_EA_EL3_FIRST		:= 0
 # operations.
 HW_ASSISTED_COHERENCY		:= 0
 
+# Only regenerate the certificates and FIP payloads whose inputs have changed
+INCREMENTAL_PACKAGING		:= 0
+
+# Choose the source to load each image from among those of the platform based on
+# how quickly and reliably they found the previous images. Disabled by default.
+IO_MULTI_SOURCE			:= 0
+
 # Set the default algorithm for the generation of Trusted Board Boot keys
 KEY_ALG				:= rsa
 
@@ -143,6 +165,9 @@ SAVE_KEYS			:= 0
 # Software Delegated Exception support
 SDEI_SUPPORT            	:= 0
 
+# Collect per-CPU dispatch statistics of SDEI events
+SDEI_STATS			:= 0
+
 # Whether code and read-only data should be put on separate memory pages. The
 # platform Makefile is free to override this value.
 SEPARATE_CODE_AND_RODATA	:= 0
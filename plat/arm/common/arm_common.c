@@ -189,6 +189,35 @@ unsigned int plat_get_syscnt_freq2(void)
 
 #endif /* ARM_SYS_CNTCTL_BASE */
 
+#ifdef IMAGE_BL31
+/* Whether [base, base + size) lies within the given region */
+static int arm_is_in_region(uint64_t base, uint64_t size,
+		uint64_t region_base, uint64_t region_size)
+{
+	return (base >= region_base) && (size <= region_size) &&
+		((base - region_base) <= (region_size - size));
+}
+
+/*
+ * Check that a range of memory provided by the Normal world lies entirely
+ * within one of the Non-secure DRAM regions.
+ */
+int plat_is_ns_mem(uint64_t base, uint64_t size)
+{
+	if (size == 0U)
+		return 0;
+
+	if (arm_is_in_region(base, size, ARM_NS_DRAM1_BASE, ARM_NS_DRAM1_SIZE))
+		return 1;
+#ifndef AARCH32
+	if (arm_is_in_region(base, size, ARM_DRAM2_BASE, ARM_DRAM2_SIZE))
+		return 1;
+#endif
+
+	return 0;
+}
+#endif /* IMAGE_BL31 */
+
 #if SDEI_SUPPORT
 /*
  * Translate SDEI entry point to PA, and perform standard ARM entry point
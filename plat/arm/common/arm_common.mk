@@ -180,6 +180,11 @@ BL2_SOURCES		+=	drivers/delay_timer/delay_timer.c		\
 				plat/arm/common/arm_err.c			\
 				plat/arm/common/arm_io_storage.c
 
+ifeq (${IO_MULTI_SOURCE},1)
+BL1_SOURCES		+=	drivers/io/io_multi_source.c
+BL2_SOURCES		+=	drivers/io/io_multi_source.c
+endif
+
 # Add `libfdt` and Arm common helpers required for Dynamic Config
 include lib/libfdt/libfdt.mk
 
@@ -9,6 +9,7 @@
 #include <io_driver.h>
 #include <io_fip.h>
 #include <io_memmap.h>
+#include <io_multi_source.h>
 #include <io_storage.h>
 #include <plat_arm.h>
 #include <platform.h>
@@ -289,6 +290,43 @@ static int open_memmap(const uintptr_t spec)
 }
 
 
+/* Load images as specified by 'policies' */
+static int arm_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+				uintptr_t *image_spec)
+{
+	int result;
+	const struct plat_io_policy *policy;
+
+	assert(image_id < ARRAY_SIZE(policies));
+
+	policy = &policies[image_id];
+	result = policy->check(policy->image_spec);
+	if (result == 0) {
+		*image_spec = policy->image_spec;
+		*dev_handle = *(policy->dev_handle);
+	}
+
+	return result;
+}
+
+#if IO_MULTI_SOURCE
+/*
+ * The image sources are ranked by how quickly they find images and how often
+ * they fail. The statistics are kept across boots if the platform provides
+ * memory preserved across resets for them.
+ */
+static const io_source_get_t arm_io_sources[] = {
+	arm_get_image_source,
+	plat_arm_get_alt_image_source,
+};
+
+#ifdef PLAT_ARM_IO_STATS_BASE
+#define arm_io_stats	(*(io_multi_source_stats_t *)PLAT_ARM_IO_STATS_BASE)
+#else
+static io_multi_source_stats_t arm_io_stats;
+#endif
+#endif /* IO_MULTI_SOURCE */
+
 void arm_io_setup(void)
 {
 	int io_result;
@@ -310,6 +348,11 @@ void arm_io_setup(void)
 
 	/* Ignore improbable errors in release builds */
 	(void)io_result;
+
+#if IO_MULTI_SOURCE
+	io_multi_source_init(arm_io_sources, ARRAY_SIZE(arm_io_sources),
+			     &arm_io_stats);
+#endif
 }
 
 void plat_arm_io_setup(void)
@@ -331,23 +374,20 @@ int plat_arm_get_alt_image_source(
 int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 			  uintptr_t *image_spec)
 {
+#if IO_MULTI_SOURCE
+	return io_multi_source_get(image_id, dev_handle, image_spec);
+#else
 	int result;
-	const struct plat_io_policy *policy;
 
-	assert(image_id < ARRAY_SIZE(policies));
-
-	policy = &policies[image_id];
-	result = policy->check(policy->image_spec);
-	if (result == 0) {
-		*image_spec = policy->image_spec;
-		*dev_handle = *(policy->dev_handle);
-	} else {
+	result = arm_get_image_source(image_id, dev_handle, image_spec);
+	if (result != 0) {
 		VERBOSE("Trying alternative IO\n");
 		result = plat_arm_get_alt_image_source(image_id, dev_handle,
 						       image_spec);
 	}
 
 	return result;
+#endif
 }
 
 /*
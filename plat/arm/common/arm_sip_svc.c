@@ -9,6 +9,9 @@
 #include <plat_arm.h>
 #include <pmf.h>
 #include <runtime_svc.h>
+#if SDEI_SUPPORT
+#include <sdei.h>
+#endif
 #include <stdint.h>
 #include <uuid.h>
 
@@ -48,6 +51,14 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 				handle, flags);
 	}
 
+#if SDEI_SUPPORT
+	/* Dispatch the implementation defined calls of the SDEI dispatcher */
+	if (is_sdei_sip_fid(smc_fid)) {
+		return sdei_sip_smc_handler(smc_fid, x1, x2, x3, x4, cookie,
+				handle, flags);
+	}
+#endif
+
 	switch (smc_fid) {
 	case ARM_SIP_SVC_EXE_STATE_SWITCH: {
 		u_register_t pc;
@@ -76,6 +87,11 @@ static uintptr_t arm_sip_handler(unsigned int smc_fid,
 		/* State switch call */
 		call_count += 1;
 
+#if SDEI_SUPPORT
+		/* SDEI calls */
+		call_count += SDEI_SIP_NUM_SMC_CALLS;
+#endif
+
 		SMC_RET1(handle, call_count);
 
 	case ARM_SIP_SVC_UID:
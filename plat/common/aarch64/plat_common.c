@@ -30,6 +30,7 @@
 #endif
 
 #pragma weak plat_ea_handler
+#pragma weak plat_is_ns_mem
 
 void bl31_plat_runtime_setup(void)
 {
@@ -99,6 +100,16 @@ int plat_sdei_validate_entry_point(uintptr_t ep, unsigned int client_mode)
 }
 #endif
 
+/*
+ * Default function to check that a range of memory provided by the Normal world
+ * is Non-secure memory, which rejects every range. Platforms which let EL3 map
+ * Non-secure memory on behalf of the Normal world must override it.
+ */
+int plat_is_ns_mem(uint64_t base, uint64_t size)
+{
+	return 0;
+}
+
 /* RAS functions common to AArch64 ARM platforms */
 void plat_ea_handler(unsigned int ea_reason, uint64_t syndrome, void *cookie,
 		void *handle, uint64_t flags)
@@ -5,18 +5,51 @@
  */
 #include <console.h>
 #include <debug.h>
+#include <fdt_wrappers.h>
 #include <libfdt.h>
+#include <platform_def.h>
 #include <psci.h>
 #include <string.h>
+#include <utils_def.h>
 #include "qemu_private.h"
 
-static int append_psci_compatible(void *fdt, int offs, const char *str)
+/* Maximum number of CPU nodes updated by a single batch of edits */
+#define DT_CPU_EDITS_MAX	PLATFORM_CORE_COUNT
+
+static void set_edit(fdtw_edit_t *edit, unsigned int op, int node,
+		     const char *name, const void *value, int len)
+{
+	edit->op = op;
+	edit->node = node;
+	edit->name = name;
+	edit->value = value;
+	edit->len = len;
+}
+
+static void set_psci_compatible(fdtw_edit_t *edit, const char *str)
+{
+	set_edit(edit, FDTW_EDIT_APPENDPROP, FDTW_EDIT_NEW_NODE(0),
+		 "compatible", str, strlen(str) + 1);
+}
+
+static void set_psci_u32(fdtw_edit_t *edit, const char *name,
+			 const fdt32_t *val)
 {
-	return fdt_appendprop(fdt, offs, "compatible", str, strlen(str) + 1);
+	set_edit(edit, FDTW_EDIT_SETPROP, FDTW_EDIT_NEW_NODE(0), name, val,
+		 sizeof(*val));
 }
 
+/* The node and all its properties are added with a single batch of edits */
 int dt_add_psci_node(void *fdt)
 {
+	const fdt32_t fns[] = {
+		cpu_to_fdt32(PSCI_CPU_SUSPEND_AARCH64),
+		cpu_to_fdt32(PSCI_CPU_OFF),
+		cpu_to_fdt32(PSCI_CPU_ON_AARCH64),
+		cpu_to_fdt32(PSCI_SYSTEM_OFF),
+		cpu_to_fdt32(PSCI_SYSTEM_RESET),
+	};
+	fdtw_edit_t edits[10];
 	int offs;
 
 	if (fdt_path_offset(fdt, "/psci") >= 0) {
@@ -27,26 +60,21 @@ int dt_add_psci_node(void *fdt)
 	offs = fdt_path_offset(fdt, "/");
 	if (offs < 0)
 		return -1;
-	offs = fdt_add_subnode(fdt, offs, "psci");
-	if (offs < 0)
-		return -1;
-	if (append_psci_compatible(fdt, offs, "arm,psci-1.0"))
-		return -1;
-	if (append_psci_compatible(fdt, offs, "arm,psci-0.2"))
-		return -1;
-	if (append_psci_compatible(fdt, offs, "arm,psci"))
-		return -1;
-	if (fdt_setprop_string(fdt, offs, "method", "smc"))
-		return -1;
-	if (fdt_setprop_u32(fdt, offs, "cpu_suspend", PSCI_CPU_SUSPEND_AARCH64))
-		return -1;
-	if (fdt_setprop_u32(fdt, offs, "cpu_off", PSCI_CPU_OFF))
-		return -1;
-	if (fdt_setprop_u32(fdt, offs, "cpu_on", PSCI_CPU_ON_AARCH64))
-		return -1;
-	if (fdt_setprop_u32(fdt, offs, "sys_poweroff", PSCI_SYSTEM_OFF))
-		return -1;
-	if (fdt_setprop_u32(fdt, offs, "sys_reset", PSCI_SYSTEM_RESET))
+
+	set_edit(&edits[0], FDTW_EDIT_ADD_SUBNODE, offs, "psci", NULL, 0);
+	set_psci_compatible(&edits[1], "arm,psci-1.0");
+	set_psci_compatible(&edits[2], "arm,psci-0.2");
+	set_psci_compatible(&edits[3], "arm,psci");
+	set_edit(&edits[4], FDTW_EDIT_SETPROP, FDTW_EDIT_NEW_NODE(0), "method",
+		 "smc", sizeof("smc"));
+	set_psci_u32(&edits[5], "cpu_suspend", &fns[0]);
+	set_psci_u32(&edits[6], "cpu_off", &fns[1]);
+	set_psci_u32(&edits[7], "cpu_on", &fns[2]);
+	set_psci_u32(&edits[8], "sys_poweroff", &fns[3]);
+	set_psci_u32(&edits[9], "sys_reset", &fns[4]);
+
+	if (fdtw_apply_edits(fdt, fdt, fdt_totalsize(fdt), edits,
+			     ARRAY_SIZE(edits)))
 		return -1;
 	return 0;
 }
@@ -74,8 +102,14 @@ static int check_node_compat_prefix(void *fdt, int offs, const char *prefix)
 	return -1;
 }
 
+/*
+ * The CPU nodes are collected in a single scan and updated with a single batch
+ * of edits, as long as there are no more than DT_CPU_EDITS_MAX of them.
+ */
 int dt_add_psci_cpu_enable_methods(void *fdt)
 {
+	fdtw_edit_t edits[DT_CPU_EDITS_MAX];
+	unsigned int num = 0;
 	int offs = 0;
 
 	while (1) {
@@ -86,10 +120,19 @@ int dt_add_psci_cpu_enable_methods(void *fdt)
 			continue; /* already set */
 		if (check_node_compat_prefix(fdt, offs, "arm,cortex-a"))
 			continue; /* no compatible */
-		if (fdt_setprop_string(fdt, offs, "enable-method", "psci"))
+		set_edit(&edits[num++], FDTW_EDIT_SETPROP, offs,
+			 "enable-method", "psci", sizeof("psci"));
+		if (num < ARRAY_SIZE(edits))
+			continue;
+		/* Need to restart scanning as offsets have changed */
+		if (fdtw_apply_edits(fdt, fdt, fdt_totalsize(fdt), edits, num))
 			return -1;
-		/* Need to restart scanning as offsets may have changed */
+		num = 0;
 		offs = 0;
 	}
+
+	if ((num != 0U) &&
+	    fdtw_apply_edits(fdt, fdt, fdt_totalsize(fdt), edits, num))
+		return -1;
 	return 0;
 }
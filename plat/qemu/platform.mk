@@ -41,6 +41,11 @@ ifeq (${ARM_ARCH_MAJOR},8)
 PLAT_INCLUDES		+=	-Iinclude/plat/arm/common/${ARCH}
 endif
 
+# Copy the images out of the flash with a stand-in for a DMA engine
+QEMU_MEMMAP_DMA		:=	0
+$(eval $(call assert_boolean,QEMU_MEMMAP_DMA))
+$(eval $(call add_define,QEMU_MEMMAP_DMA))
+
 # Use translation tables library v2 by default
 ARM_XLAT_TABLES_LIB_V1		:=	0
 $(eval $(call assert_boolean,ARM_XLAT_TABLES_LIB_V1))
@@ -123,7 +128,8 @@ else
 BL1_SOURCES		+=	lib/cpus/${ARCH}/cortex_a15.S
 endif
 
-BL2_SOURCES		+=	drivers/io/io_semihosting.c		\
+BL2_SOURCES		+=	common/fdt_wrappers.c			\
+				drivers/io/io_semihosting.c		\
 				drivers/io/io_storage.c			\
 				drivers/io/io_fip.c			\
 				drivers/io/io_memmap.c			\
@@ -139,6 +145,10 @@ BL2_SOURCES		+=	plat/qemu/qemu_bl2_mem_params_desc.c	\
 				plat/qemu/qemu_image_load.c		\
 				common/desc_image_load.c
 endif
+ifeq (${IO_MULTI_SOURCE},1)
+BL1_SOURCES		+=	drivers/io/io_multi_source.c
+BL2_SOURCES		+=	drivers/io/io_multi_source.c
+endif
 ifeq ($(add-lib-optee),yes)
 BL2_SOURCES		+=	lib/optee/optee_utils.c
 endif
@@ -4,18 +4,22 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <arch_helpers.h>
 #include <assert.h>
 #include <bl_common.h>		/* For ARRAY_SIZE */
 #include <debug.h>
+#include <errno.h>
 #include <firmware_image_package.h>
 #include <io_driver.h>
 #include <io_fip.h>
 #include <io_memmap.h>
+#include <io_multi_source.h>
 #include <io_semihosting.h>
 #include <io_storage.h>
 #include <platform_def.h>
 #include <semihosting.h>
 #include <string.h>
+#include <utils_def.h>
 
 /* Semihosting filenames */
 #define BL2_IMAGE_NAME			"bl2.bin"
@@ -174,6 +178,10 @@ static const io_file_spec_t sh_file_spec[] = {
 
 static int open_fip(const uintptr_t spec);
 static int open_memmap(const uintptr_t spec);
+static int get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			    uintptr_t *image_spec);
+static int get_alt_image_source(unsigned int image_id, uintptr_t *dev_handle,
+				uintptr_t *image_spec);
 
 struct plat_io_policy {
 	uintptr_t *dev_handle;
@@ -312,6 +320,63 @@ static int open_semihosting(const uintptr_t spec)
 	return result;
 }
 
+#if IO_MULTI_SOURCE
+/* Images are loaded from the FIP or semihosting, whichever is quicker */
+static const io_source_get_t qemu_io_sources[] = {
+	get_image_source,
+	get_alt_image_source,
+};
+
+static io_multi_source_stats_t qemu_io_stats;
+#endif
+
+#if QEMU_MEMMAP_DMA
+/*
+ * Stand-in for a DMA engine, to exercise the DMA path of the memmap driver.
+ * The CPU does the copy, a chunk at each poll, and writes it back to memory as
+ * a DMA engine would.
+ */
+#define QEMU_DMA_CHUNK		0x10000
+
+static struct {
+	uintptr_t dst;
+	uintptr_t src;
+	size_t left;
+} qemu_dma;
+
+static int qemu_dma_start(uintptr_t dst, uintptr_t src, size_t length)
+{
+	if (qemu_dma.left != 0)
+		return -EBUSY;
+
+	qemu_dma.dst = dst;
+	qemu_dma.src = src;
+	qemu_dma.left = length;
+
+	return 0;
+}
+
+static int qemu_dma_poll(void)
+{
+	size_t length = MIN(qemu_dma.left, (size_t)QEMU_DMA_CHUNK);
+
+	memcpy((void *)qemu_dma.dst, (void *)qemu_dma.src, length);
+	flush_dcache_range(qemu_dma.dst, length);
+
+	qemu_dma.dst += length;
+	qemu_dma.src += length;
+	qemu_dma.left -= length;
+
+	return (qemu_dma.left != 0) ? -EBUSY : 0;
+}
+
+static const io_memmap_dma_ops_t qemu_dma_ops = {
+	.start = qemu_dma_start,
+	.poll = qemu_dma_poll,
+	.min_length = QEMU_DMA_CHUNK,
+};
+#endif /* QEMU_MEMMAP_DMA */
+
 void plat_qemu_io_setup(void)
 {
 	int io_result;
@@ -331,6 +396,10 @@ void plat_qemu_io_setup(void)
 				&memmap_dev_handle);
 	assert(io_result == 0);
 
+#if QEMU_MEMMAP_DMA
+	io_memmap_set_dma(&qemu_dma_ops);
+#endif
+
 	/* Register the additional IO devices on this platform */
 	io_result = register_io_dev_sh(&sh_dev_con);
 	assert(io_result == 0);
@@ -341,6 +410,11 @@ void plat_qemu_io_setup(void)
 
 	/* Ignore improbable errors in release builds */
 	(void)io_result;
+
+#if IO_MULTI_SOURCE
+	io_multi_source_init(qemu_io_sources, ARRAY_SIZE(qemu_io_sources),
+			     &qemu_io_stats);
+#endif
 }
 
 static int get_alt_image_source(unsigned int image_id, uintptr_t *dev_handle,
@@ -356,12 +430,8 @@ static int get_alt_image_source(unsigned int image_id, uintptr_t *dev_handle,
 	return result;
 }
 
-/*
- * Return an IO device handle and specification which can be used to access
- * an image. Use this to enforce platform load policy
- */
-int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
-			  uintptr_t *image_spec)
+static int get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			    uintptr_t *image_spec)
 {
 	int result;
 	const struct plat_io_policy *policy;
@@ -373,10 +443,29 @@ int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
 	if (result == 0) {
 		*image_spec = policy->image_spec;
 		*dev_handle = *(policy->dev_handle);
-	} else {
+	}
+
+	return result;
+}
+
+/*
+ * Return an IO device handle and specification which can be used to access
+ * an image. Use this to enforce platform load policy
+ */
+int plat_get_image_source(unsigned int image_id, uintptr_t *dev_handle,
+			  uintptr_t *image_spec)
+{
+#if IO_MULTI_SOURCE
+	return io_multi_source_get(image_id, dev_handle, image_spec);
+#else
+	int result;
+
+	result = get_image_source(image_id, dev_handle, image_spec);
+	if (result != 0) {
 		VERBOSE("Trying alternative IO\n");
 		result = get_alt_image_source(image_id, dev_handle, image_spec);
 	}
 
 	return result;
+#endif
 }
@@ -22,6 +22,8 @@ struct dt_node_info {
  ******************************************************************************/
 int dt_open_and_check(void);
 int fdt_get_address(void **fdt_addr);
+int dt_node_offset_by_compatible(const char *compat);
+int dt_node_offset_by_phandle(uint32_t phandle);
 bool fdt_check_node(int node);
 bool fdt_check_status(int node);
 bool fdt_check_secure_status(int node);
@@ -6,6 +6,7 @@
 
 #include <assert.h>
 #include <debug.h>
+#include <fdt_wrappers.h>
 #include <libfdt.h>
 #include <platform_def.h>
 #include <stm32_gpio.h>
@@ -21,7 +22,13 @@
 #define DT_GPIO_PIN_MASK	0xF00U
 #define DT_GPIO_MODE_MASK	0xFFU
 
+/* Number of compatible strings and phandles of the DT that can be indexed */
+#define DT_INDEX_ENTRIES	128U
+
 static int fdt_checked;
+static int fdt_indexed;
+static fdtw_index_t fdt_index;
+static fdtw_index_entry_t fdt_index_arena[DT_INDEX_ENTRIES];
 
 static void *fdt = (void *)(uintptr_t)STM32MP1_DTB_BASE;
 
@@ -149,6 +156,15 @@ int dt_open_and_check(void)
 
 	if (ret == 0) {
 		fdt_checked = 1;
+
+		/*
+		 * Lookups fall back to libfdt if the DT has more nodes than
+		 * the index can hold.
+		 */
+		if (fdtw_index_init(&fdt_index, fdt, fdt_index_arena,
+				    sizeof(fdt_index_arena)) == 0) {
+			fdt_indexed = 1;
+		}
 	}
 
 	return ret;
@@ -168,6 +184,32 @@ int fdt_get_address(void **fdt_addr)
 	return fdt_checked;
 }
 
+/*******************************************************************************
+ * This function gets the first node compatible with compat.
+ * Returns node if success, and a negative value else.
+ ******************************************************************************/
+int dt_node_offset_by_compatible(const char *compat)
+{
+	if (fdt_indexed == 1) {
+		return fdtw_node_offset_by_compatible(&fdt_index, compat);
+	}
+
+	return fdt_node_offset_by_compatible(fdt, -1, compat);
+}
+
+/*******************************************************************************
+ * This function gets the node referenced by phandle.
+ * Returns node if success, and a negative value else.
+ ******************************************************************************/
+int dt_node_offset_by_phandle(uint32_t phandle)
+{
+	if (fdt_indexed == 1) {
+		return fdtw_node_offset_by_phandle(&fdt_index, phandle);
+	}
+
+	return fdt_node_offset_by_phandle(fdt, phandle);
+}
+
 /*******************************************************************************
  * This function check the presence of a node (generic use of fdt library).
  * Returns true if present, false else.
@@ -292,8 +334,7 @@ int dt_set_pinctrl_config(int node)
 	for (i = 0; i < ((uint32_t)lenp / 4U); i++) {
 		int phandle_node, phandle_subnode;
 
-		phandle_node =
-			fdt_node_offset_by_phandle(fdt, fdt32_to_cpu(*cuint));
+		phandle_node = dt_node_offset_by_phandle(fdt32_to_cpu(*cuint));
 		if (phandle_node < 0) {
 			return -FDT_ERR_NOTFOUND;
 		}
@@ -371,7 +412,11 @@ int dt_get_node(struct dt_node_info *info, int offset, const char *compat)
 {
 	int node;
 
-	node = fdt_node_offset_by_compatible(fdt, offset, compat);
+	if (offset < 0) {
+		node = dt_node_offset_by_compatible(compat);
+	} else {
+		node = fdt_node_offset_by_compatible(fdt, offset, compat);
+	}
 	if (node < 0) {
 		return -FDT_ERR_NOTFOUND;
 	}
@@ -450,7 +495,7 @@ uint32_t dt_get_ddr_size(void)
 {
 	int node;
 
-	node = fdt_node_offset_by_compatible(fdt, -1, DT_DDR_COMPAT);
+	node = dt_node_offset_by_compatible(DT_DDR_COMPAT);
 	if (node < 0) {
 		INFO("%s: Cannot read DDR node in DT\n", __func__);
 		return STM32MP1_DDR_SIZE_DFLT;
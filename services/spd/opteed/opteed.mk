@@ -13,3 +13,14 @@ SPD_SOURCES		:=	services/spd/opteed/opteed_common.c	\
 				services/spd/opteed/opteed_pm.c
 
 NEED_BL32		:=	yes
+
+# Flag used to let the normal world queue OPTEE calls in a shared memory ring
+# and issue them with a single SMC.
+OPTEED_BATCH_SMC	:=	0
+
+$(eval $(call assert_boolean,OPTEED_BATCH_SMC))
+$(eval $(call add_define,OPTEED_BATCH_SMC))
+
+ifeq (${OPTEED_BATCH_SMC},1)
+SPD_SOURCES		+=	services/spd/opteed/opteed_batch.c
+endif
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <bl31.h>
+#include <context_mgmt.h>
+#include <debug.h>
+#include <errno.h>
+#include <platform_def.h>
+#include <runtime_svc.h>
+#include <xlat_tables_v2.h>
+#include "opteed_private.h"
+
+#if !PLAT_XLAT_TABLES_DYNAMIC
+#error "OPTEED_BATCH_SMC requires PLAT_XLAT_TABLES_DYNAMIC"
+#endif
+
+/* Size of the region mapped for a ring with 'entries' entries */
+static size_t opteed_batch_ring_size(uint32_t entries)
+{
+	return round_up(sizeof(opteed_batch_ring_t) +
+			entries * sizeof(opteed_batch_entry_t), PAGE_SIZE);
+}
+
+/* Convert the error returned by the translation table library */
+static uint64_t opteed_batch_map_error(int rc)
+{
+	return (rc == -ENOMEM) ? OPTEE_SMC_RETURN_ENOMEM :
+				 OPTEE_SMC_RETURN_EBADADDR;
+}
+
+/*******************************************************************************
+ * Register the request ring of the calling cpu, or unregister it when 'size' is
+ * 0. The ring is mapped in the EL3 translation regime at its physical address
+ * for as long as it is registered.
+ ******************************************************************************/
+uint64_t opteed_batch_register(optee_context_t *optee_ctx, uint64_t base,
+			       uint64_t size)
+{
+	uint64_t entries, ret = OPTEE_SMC_RETURN_OK;
+	int rc;
+
+	if ((size != 0) &&
+	    (((base & (PAGE_SIZE - 1)) != 0) ||
+	     ((size & (PAGE_SIZE - 1)) != 0) ||
+	     (size <= sizeof(opteed_batch_ring_t)) ||
+	     (size > OPTEED_BATCH_MAX_SIZE))) {
+		VERBOSE("OPTEED: invalid batch ring 0x%llx size 0x%llx\n",
+			(unsigned long long)base, (unsigned long long)size);
+		return OPTEE_SMC_RETURN_EBADADDR;
+	}
+
+	entries = (size - sizeof(opteed_batch_ring_t)) /
+		  sizeof(opteed_batch_entry_t);
+	if ((size != 0) && (entries == 0))
+		return OPTEE_SMC_RETURN_EBADADDR;
+
+	/*
+	 * The translation tables are shared with the other services which map
+	 * Non-secure memory at runtime, so they are only changed under the
+	 * lock provided by BL31.
+	 */
+	bl31_ns_mem_lock_acquire();
+
+	if (optee_ctx->batch_ring != NULL) {
+		rc = bl31_unmap_ns_mem((uintptr_t)optee_ctx->batch_ring,
+				opteed_batch_ring_size(optee_ctx->batch_entries));
+		if (rc != 0) {
+			ret = OPTEE_SMC_RETURN_EBUSY;
+			goto exit;
+		}
+
+		optee_ctx->batch_ring = NULL;
+		optee_ctx->batch_entries = 0;
+	}
+
+	if (size == 0)
+		goto exit;
+
+	/* The ring is rejected unless the platform reports it as Non-secure */
+	rc = bl31_map_ns_mem((uintptr_t)base, opteed_batch_ring_size(entries));
+	if (rc != 0) {
+		VERBOSE("OPTEED: failed to map batch ring 0x%llx (%d)\n",
+			(unsigned long long)base, rc);
+		ret = opteed_batch_map_error(rc);
+		goto exit;
+	}
+
+	optee_ctx->batch_ring = (opteed_batch_ring_t *)base;
+	optee_ctx->batch_entries = entries;
+	optee_ctx->batch_head = 0;
+	optee_ctx->batch_ring->head = 0;
+
+exit:
+	bl31_ns_mem_lock_release();
+
+	return ret;
+}
+
+/*******************************************************************************
+ * Issue one queued call to OPTEE through a synchronous entry. OPTEE reports
+ * completion through TEESMC_OPTEED_RETURN_CALL_DONE, which is diverted to
+ * opteed_batch_call_done() while 'batch_active' is set.
+ ******************************************************************************/
+static void opteed_batch_issue(optee_context_t *optee_ctx,
+			       const uint64_t *args)
+{
+	cpu_context_t *ctx = &optee_ctx->cpu_ctx;
+	uint32_t fid = (uint32_t)args[0];
+	unsigned int i;
+
+	if ((GET_SMC_OEN(fid) < OEN_TOS_START) ||
+	    (GET_SMC_OEN(fid) > OEN_TOS_END) ||
+	    (GET_SMC_OEN(fid) == OPTEED_BATCH_OEN)) {
+		optee_ctx->batch_rets[0] = SMC_UNK;
+		optee_ctx->batch_rets[1] = 0;
+		optee_ctx->batch_rets[2] = 0;
+		optee_ctx->batch_rets[3] = 0;
+		return;
+	}
+
+	if (GET_SMC_TYPE(fid) == SMC_TYPE_FAST) {
+		cm_set_elr_el3(SECURE, (uint64_t)
+				&optee_vector_table->fast_smc_entry);
+	} else {
+		cm_set_elr_el3(SECURE, (uint64_t)
+				&optee_vector_table->yield_smc_entry);
+	}
+
+	for (i = 0; i < OPTEED_BATCH_NUM_ARGS; i++)
+		write_ctx_reg(get_gpregs_ctx(ctx),
+			      (CTX_GPREG_X0 + (i << DWORD_SHIFT)), args[i]);
+
+	/* Cleared by OPTEE reporting completion through opteed_smc_handler() */
+	if (GET_SMC_TYPE(fid) == SMC_TYPE_YIELD)
+		optee_ctx->yield_active = 1;
+
+	optee_ctx->batch_active = 1;
+	opteed_synchronous_sp_entry(optee_ctx);
+	optee_ctx->batch_active = 0;
+}
+
+/*******************************************************************************
+ * Issue the calls queued in the request ring of the calling cpu to OPTEE, back
+ * to back, and write their results to the ring. This stops early at the first
+ * call for which OPTEE requests an RPC: the normal world has to serve it and
+ * resume the call with a regular SMC before running the remaining entries.
+ * On success, the number of completed entries is returned in 'count'.
+ ******************************************************************************/
+uint64_t opteed_batch_run(optee_context_t *optee_ctx, uint32_t *count)
+{
+	volatile opteed_batch_ring_t *ring = optee_ctx->batch_ring;
+	volatile opteed_batch_entry_t *entry;
+	uint64_t args[OPTEED_BATCH_NUM_ARGS];
+	uint32_t head, tail;
+	unsigned int i;
+
+	*count = 0;
+
+	if ((ring == NULL) ||
+	    (get_optee_pstate(optee_ctx->state) != OPTEE_PSTATE_ON))
+		return OPTEE_SMC_RETURN_ENOTAVAIL;
+
+	/*
+	 * The secure context of this cpu can't be reused while OPTEE hasn't
+	 * completed a yielding call issued on it.
+	 */
+	if (optee_ctx->yield_active != 0)
+		return OPTEE_SMC_RETURN_EBUSY;
+
+	/* The ring lives in normal world memory: only trust our own head */
+	head = optee_ctx->batch_head;
+	tail = ring->tail;
+	if (tail >= optee_ctx->batch_entries)
+		return OPTEE_SMC_RETURN_EBADCMD;
+
+	if (head == tail)
+		return OPTEE_SMC_RETURN_OK;
+
+	cm_el1_sysregs_context_save(NON_SECURE);
+
+	while (head != tail) {
+		entry = &ring->entries[head];
+
+		/* Copy the arguments so they can't change under our feet */
+		for (i = 0; i < OPTEED_BATCH_NUM_ARGS; i++)
+			args[i] = entry->args[i];
+
+		opteed_batch_issue(optee_ctx, args);
+
+		for (i = 0; i < OPTEED_BATCH_NUM_RETS; i++)
+			entry->rets[i] = optee_ctx->batch_rets[i];
+
+		head = (head + 1) % optee_ctx->batch_entries;
+		(*count)++;
+
+		if ((optee_ctx->batch_rets[0] &
+		     OPTEE_SMC_RETURN_RPC_PREFIX_MASK) ==
+		    OPTEE_SMC_RETURN_RPC_PREFIX)
+			break;
+	}
+
+	optee_ctx->batch_head = head;
+	ring->head = head;
+
+	cm_el1_sysregs_context_restore(NON_SECURE);
+	cm_set_next_eret_context(NON_SECURE);
+
+	return OPTEE_SMC_RETURN_OK;
+}
+
+/*******************************************************************************
+ * OPTEE has completed the call issued by opteed_batch_issue(). Stash the
+ * results and return to the OPTEED C runtime context which issued it.
+ ******************************************************************************/
+void opteed_batch_call_done(optee_context_t *optee_ctx, uint64_t x1,
+			    uint64_t x2, uint64_t x3, uint64_t x4)
+{
+	assert(optee_ctx->batch_active != 0);
+
+	optee_ctx->batch_rets[0] = x1;
+	optee_ctx->batch_rets[1] = x2;
+	optee_ctx->batch_rets[2] = x3;
+	optee_ctx->batch_rets[3] = x4;
+
+	opteed_synchronous_sp_exit(optee_ctx, 0);
+}
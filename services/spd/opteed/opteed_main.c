@@ -214,6 +214,24 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(handle == cm_get_context(NON_SECURE));
 
+#if OPTEED_BATCH_SMC
+		switch (smc_fid) {
+		case OPTEED_SMC_BATCH_REGISTER:
+			SMC_RET1(handle,
+				 opteed_batch_register(optee_ctx, x1, x2));
+
+		case OPTEED_SMC_BATCH_RUN: {
+			uint32_t count;
+
+			rc = opteed_batch_run(optee_ctx, &count);
+			SMC_RET2(handle, rc, count);
+		}
+
+		default:
+			break;
+		}
+#endif
+
 		cm_el1_sysregs_context_save(NON_SECURE);
 
 		/*
@@ -230,6 +248,11 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 */
 		assert(&optee_ctx->cpu_ctx == cm_get_context(SECURE));
 
+#if OPTEED_BATCH_SMC
+		if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_YIELD)
+			optee_ctx->yield_active = 1;
+#endif
+
 		/* Set appropriate entry for SMC.
 		 * We expect OPTEE to manage the PSTATE.I and PSTATE.F
 		 * flags as appropriate.
@@ -360,6 +383,13 @@ static uintptr_t opteed_smc_handler(uint32_t smc_fid,
 		 * and return to the non-secure state.
 		 */
 		assert(handle == cm_get_context(SECURE));
+#if OPTEED_BATCH_SMC
+		optee_ctx->yield_active = 0;
+
+		/* The call was issued from the normal world request ring */
+		if (optee_ctx->batch_active != 0)
+			opteed_batch_call_done(optee_ctx, x1, x2, x3, x4);
+#endif
 		cm_el1_sysregs_context_save(SECURE);
 
 		/* Get a reference to the non-secure context */
@@ -78,6 +78,42 @@
 #define OPTEED_C_RT_CTX_SIZE		0x60
 #define OPTEED_C_RT_CTX_ENTRIES		(OPTEED_C_RT_CTX_SIZE >> DWORD_SHIFT)
 
+/*******************************************************************************
+ * SMCs handled by the OPTEED itself on behalf of the normal world when built
+ * with OPTEED_BATCH_SMC. They use the owning entity number of the function IDs
+ * OPTEE returns to the OPTEED with, so they never reach OPTEE.
+ ******************************************************************************/
+#define OPTEED_BATCH_OEN		62
+#define OPTEED_FUNCID_BATCH_REGISTER	0x100
+#define OPTEED_FUNCID_BATCH_RUN		0x101
+#define OPTEED_BATCH_FID(func_num)	((SMC_TYPE_FAST << FUNCID_TYPE_SHIFT) | \
+					 (SMC_64 << FUNCID_CC_SHIFT) |	       \
+					 (OPTEED_BATCH_OEN << FUNCID_OEN_SHIFT) | \
+					 (func_num))
+#define OPTEED_SMC_BATCH_REGISTER	OPTEED_BATCH_FID(OPTEED_FUNCID_BATCH_REGISTER)
+#define OPTEED_SMC_BATCH_RUN		OPTEED_BATCH_FID(OPTEED_FUNCID_BATCH_RUN)
+
+/* Number of argument and result registers of a queued OPTEE call */
+#define OPTEED_BATCH_NUM_ARGS		8
+#define OPTEED_BATCH_NUM_RETS		4
+
+/* Largest request ring the normal world may register on a cpu */
+#ifndef OPTEED_BATCH_MAX_SIZE
+#define OPTEED_BATCH_MAX_SIZE		(16 * PAGE_SIZE)
+#endif
+
+/* OPTEE return codes in x0, also used by the OPTEED batch calls */
+#define OPTEE_SMC_RETURN_OK			0x0
+#define OPTEE_SMC_RETURN_EBUSY			0x2
+#define OPTEE_SMC_RETURN_EBADADDR		0x4
+#define OPTEE_SMC_RETURN_EBADCMD		0x5
+#define OPTEE_SMC_RETURN_ENOMEM			0x6
+#define OPTEE_SMC_RETURN_ENOTAVAIL		0x7
+
+/* OPTEE return codes in x0 which request an RPC from the normal world */
+#define OPTEE_SMC_RETURN_RPC_PREFIX_MASK	0xffff0000
+#define OPTEE_SMC_RETURN_RPC_PREFIX		0xffff0000
+
 #ifndef __ASSEMBLY__
 
 #include <cassert.h>
@@ -103,6 +139,27 @@ typedef struct optee_vectors {
  */
 #define OPTEE_NUM_ARGS	0x2
 
+#if OPTEED_BATCH_SMC
+/*
+ * Layout of the request ring registered by the normal world on each CPU. The
+ * normal world fills the entries in [head, tail) with the registers of the
+ * OPTEE calls to issue and advances 'tail'. OPTEED_SMC_BATCH_RUN issues them
+ * in order, writes the registers returned by OPTEE back to each entry and
+ * advances 'head' past the completed ones.
+ */
+typedef struct opteed_batch_entry {
+	uint64_t args[OPTEED_BATCH_NUM_ARGS];
+	uint64_t rets[OPTEED_BATCH_NUM_RETS];
+} opteed_batch_entry_t;
+
+typedef struct opteed_batch_ring {
+	uint32_t head;
+	uint32_t tail;
+	uint64_t reserved;
+	opteed_batch_entry_t entries[];
+} opteed_batch_ring_t;
+#endif
+
 /* AArch64 callee saved general purpose register context structure. */
 DEFINE_REG_STRUCT(c_rt_regs, OPTEED_C_RT_CTX_ENTRIES);
 
@@ -121,12 +178,26 @@ CASSERT(OPTEED_C_RT_CTX_SIZE == sizeof(c_rt_regs_t),	\
  * 'c_rt_ctx'       - stack address to restore C runtime context from after
  *                    returning from a synchronous entry into OPTEE.
  * 'cpu_ctx'        - space to maintain OPTEE architectural state
+ * 'batch_ring'     - request ring registered by the normal world on this cpu
+ * 'batch_entries'  - number of entries in 'batch_ring'
+ * 'batch_head'     - next entry of 'batch_ring' to issue to OPTEE
+ * 'batch_active'   - set while an entry of 'batch_ring' is handled by OPTEE
+ * 'batch_rets'     - registers returned by OPTEE for that entry
+ * 'yield_active'   - set while a yielding call is handled by OPTEE
  ******************************************************************************/
 typedef struct optee_context {
 	uint32_t state;
 	uint64_t mpidr;
 	uint64_t c_rt_ctx;
 	cpu_context_t cpu_ctx;
+#if OPTEED_BATCH_SMC
+	opteed_batch_ring_t *batch_ring;
+	uint32_t batch_entries;
+	uint32_t batch_head;
+	uint32_t batch_active;
+	uint64_t batch_rets[OPTEED_BATCH_NUM_RETS];
+	uint32_t yield_active;
+#endif
 } optee_context_t;
 
 /* OPTEED power management handlers */
@@ -151,6 +222,13 @@ void opteed_init_optee_ep_state(struct entry_point_info *optee_entry_point,
 				uint64_t mem_limit,
 				uint64_t dt_addr,
 				optee_context_t *optee_ctx);
+#if OPTEED_BATCH_SMC
+uint64_t opteed_batch_register(optee_context_t *optee_ctx, uint64_t base,
+			       uint64_t size);
+uint64_t opteed_batch_run(optee_context_t *optee_ctx, uint32_t *count);
+void __dead2 opteed_batch_call_done(optee_context_t *optee_ctx, uint64_t x1,
+				    uint64_t x2, uint64_t x3, uint64_t x4);
+#endif
 
 extern optee_context_t opteed_sp_context[OPTEED_CORE_COUNT];
 extern uint32_t opteed_rw;
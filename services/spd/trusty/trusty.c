@@ -72,6 +72,24 @@ static uint32_t is_hypervisor_mode(void)
 	return !!(hcr & HYP_ENABLE_FLAG);
 }
 
+/*
+ * With CTX_LAZY_FPREGS, the FP registers are switched by BL31 on their first
+ * use in the other world, so there is nothing to do on a world switch.
+ */
+static void trusty_fpregs_save(uint32_t security_state)
+{
+#if !CTX_LAZY_FPREGS
+	fpregs_context_save(get_fpregs_ctx(cm_get_context(security_state)));
+#endif
+}
+
+static void trusty_fpregs_restore(uint32_t security_state)
+{
+#if !CTX_LAZY_FPREGS
+	fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+#endif
+}
+
 static struct args trusty_context_switch(uint32_t security_state, uint64_t r0,
 					 uint64_t r1, uint64_t r2, uint64_t r3)
 {
@@ -104,7 +122,7 @@ static struct args trusty_context_switch(uint32_t security_state, uint64_t r0,
 	 * going here.
 	 */
 	if (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME)
-		fpregs_context_save(get_fpregs_ctx(cm_get_context(security_state)));
+		trusty_fpregs_save(security_state);
 	cm_el1_sysregs_context_save(security_state);
 
 	ctx->saved_security_state = security_state;
@@ -114,7 +132,7 @@ static struct args trusty_context_switch(uint32_t security_state, uint64_t r0,
 
 	cm_el1_sysregs_context_restore(security_state);
 	if (r0 != SMC_FC_CPU_SUSPEND && r0 != SMC_FC_CPU_RESUME)
-		fpregs_context_restore(get_fpregs_ctx(cm_get_context(security_state)));
+		trusty_fpregs_restore(security_state);
 
 	cm_set_next_eret_context(security_state);
 
@@ -293,7 +311,7 @@ static int32_t trusty_init(void)
 	ep_info = bl31_plat_get_next_image_ep_info(SECURE);
 	assert(ep_info);
 
-	fpregs_context_save(get_fpregs_ctx(cm_get_context(NON_SECURE)));
+	trusty_fpregs_save(NON_SECURE);
 	cm_el1_sysregs_context_save(NON_SECURE);
 
 	cm_set_context(&ctx->cpu_ctx, SECURE);
@@ -310,7 +328,7 @@ static int32_t trusty_init(void)
 	}
 
 	cm_el1_sysregs_context_restore(SECURE);
-	fpregs_context_restore(get_fpregs_ctx(cm_get_context(SECURE)));
+	trusty_fpregs_restore(SECURE);
 	cm_set_next_eret_context(SECURE);
 
 	ctx->saved_security_state = ~0; /* initial saved state is invalid */
@@ -319,7 +337,7 @@ static int32_t trusty_init(void)
 	trusty_context_switch_helper(&ctx->saved_sp, &zero_args);
 
 	cm_el1_sysregs_context_restore(NON_SECURE);
-	fpregs_context_restore(get_fpregs_ctx(cm_get_context(NON_SECURE)));
+	trusty_fpregs_restore(NON_SECURE);
 	cm_set_next_eret_context(NON_SECURE);
 
 	return 0;
@@ -51,3 +51,10 @@ endif
 
 $(eval $(call assert_boolean,TSP_NS_INTR_ASYNC_PREEMPT))
 $(eval $(call add_define,TSP_NS_INTR_ASYNC_PREEMPT))
+
+# Flag used to handle fast SMCs to the TSP through a direct path which only
+# switches the EL1 system registers used by the TSP on its fast SMC path.
+TSPD_DIRECT_FAST_SMC		:=	0
+
+$(eval $(call assert_boolean,TSPD_DIRECT_FAST_SMC))
+$(eval $(call add_define,TSPD_DIRECT_FAST_SMC))
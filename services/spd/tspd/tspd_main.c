@@ -19,10 +19,13 @@
 #include <bl31.h>
 #include <bl_common.h>
 #include <context_mgmt.h>
+#include <cpu_data.h>
 #include <debug.h>
 #include <ehf.h>
 #include <errno.h>
 #include <platform.h>
+#include <pmf.h>
+#include <runtime_instr.h>
 #include <runtime_svc.h>
 #include <stddef.h>
 #include <string.h>
@@ -264,6 +267,75 @@ int32_t tspd_init(void)
 	return rc;
 }
 
+#if TSPD_DIRECT_FAST_SMC
+/*
+ * Whatever the secure payload uses, the fast SMC path must switch the system
+ * control, translation, vector base and stack registers of EL1. Otherwise the
+ * secure payload would run on the translation tables and vectors of the normal
+ * world.
+ */
+#define TSPD_FAST_SMC_EL1_ISOLATION	(BIT_32(CTX_EL1_SCTLR_ACTLR_BIT) |	\
+					 BIT_32(CTX_EL1_TTBR_BIT) |		\
+					 BIT_32(CTX_EL1_TCR_TPIDR_BIT) |	\
+					 BIT_32(CTX_EL1_MAIR_BIT) |		\
+					 BIT_32(CTX_EL1_CONTEXTIDR_VBAR_BIT) |	\
+					 BIT_32(CTX_EL1_SP_ESR_BIT))
+
+CASSERT((TSPD_FAST_SMC_EL1_SYSREGS & TSPD_FAST_SMC_EL1_ISOLATION) ==
+	TSPD_FAST_SMC_EL1_ISOLATION, assert_tspd_fast_smc_el1_isolation);
+
+/*******************************************************************************
+ * Direct path for fast SMCs from the normal world to the TSP. Only the EL1
+ * system registers used by the TSP on its fast SMC path are switched, and the
+ * entry point and arguments are written straight into the secure context.
+ ******************************************************************************/
+static uintptr_t tspd_fast_smc_enter(tsp_context_t *tsp_ctx, uint32_t smc_fid,
+				     u_register_t x1, u_register_t x2)
+{
+	cpu_context_t *s_cpu_context = &tsp_ctx->cpu_ctx;
+
+	assert(s_cpu_context == cm_get_context(SECURE));
+
+	cm_el1_sysregs_context_save_partial(NON_SECURE,
+					    TSPD_FAST_SMC_EL1_SYSREGS);
+
+	/* Save x1 and x2 for use by TSP_GET_ARGS call */
+	store_tsp_args(tsp_ctx, x1, x2);
+
+	write_ctx_reg(get_el3state_ctx(s_cpu_context), CTX_ELR_EL3,
+		      (uint64_t) &tsp_vectors->fast_smc_entry);
+
+	cm_el1_sysregs_context_restore_partial(SECURE,
+					       TSPD_FAST_SMC_EL1_SYSREGS);
+	cm_set_next_eret_context(SECURE);
+	SMC_RET3(s_cpu_context, smc_fid, x1, x2);
+}
+
+/*******************************************************************************
+ * Return the results of a fast SMC handled by the TSP, in x1-x3, to the normal
+ * world. This is the counterpart of tspd_fast_smc_enter().
+ ******************************************************************************/
+static uintptr_t tspd_fast_smc_return(u_register_t x1, u_register_t x2,
+				      u_register_t x3)
+{
+	cpu_context_t *ns_cpu_context = cm_get_context(NON_SECURE);
+
+	assert(ns_cpu_context);
+
+	cm_el1_sysregs_context_save_partial(SECURE, TSPD_FAST_SMC_EL1_SYSREGS);
+	cm_el1_sysregs_context_restore_partial(NON_SECURE,
+					       TSPD_FAST_SMC_EL1_SYSREGS);
+	cm_set_next_eret_context(NON_SECURE);
+
+#if ENABLE_RUNTIME_INSTRUMENTATION
+	PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+	    RT_INSTR_EXIT_TSP_FAST_SMC,
+	    PMF_NO_CACHE_MAINT);
+#endif
+
+	SMC_RET3(ns_cpu_context, x1, x2, x3);
+}
+#endif
 
 /*******************************************************************************
  * This function is responsible for handling all SMCs in the Trusted OS/App
@@ -505,6 +577,24 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 			if (get_yield_smc_active_flag(tsp_ctx->state))
 				SMC_RET1(handle, SMC_UNK);
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+			/*
+			 * Time fast SMCs from their entry into EL3 until the
+			 * result is returned to the normal world.
+			 */
+			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST)
+				PMF_WRITE_TIMESTAMP(rt_instr_svc,
+				    RT_INSTR_ENTER_TSP_FAST_SMC,
+				    PMF_NO_CACHE_MAINT,
+				    get_cpu_data(cpu_data_pmf_ts[CPU_DATA_PMF_TS0_IDX]));
+#endif
+
+#if TSPD_DIRECT_FAST_SMC
+			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST)
+				return tspd_fast_smc_enter(tsp_ctx, smc_fid,
+							   x1, x2);
+#endif
+
 			cm_el1_sysregs_context_save(NON_SECURE);
 
 			/* Save x1 and x2 for use by TSP_GET_ARGS call below */
@@ -569,6 +659,12 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 			 * and return to the non-secure state.
 			 */
 			assert(handle == cm_get_context(SECURE));
+
+#if TSPD_DIRECT_FAST_SMC
+			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST)
+				return tspd_fast_smc_return(x1, x2, x3);
+#endif
+
 			cm_el1_sysregs_context_save(SECURE);
 
 			/* Get a reference to the non-secure context */
@@ -590,6 +686,13 @@ static uintptr_t tspd_smc_handler(uint32_t smc_fid,
 #endif
 			}
 
+#if ENABLE_RUNTIME_INSTRUMENTATION
+			if (GET_SMC_TYPE(smc_fid) == SMC_TYPE_FAST)
+				PMF_CAPTURE_TIMESTAMP(rt_instr_svc,
+				    RT_INSTR_EXIT_TSP_FAST_SMC,
+				    PMF_NO_CACHE_MAINT);
+#endif
+
 			SMC_RET3(ns_cpu_context, x1, x2, x3);
 		}
 
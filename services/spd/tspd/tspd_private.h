@@ -129,6 +129,7 @@
 
 #include <cassert.h>
 #include <stdint.h>
+#include <utils_def.h>
 
 /*
  * The number of arguments to save during a SMC call for TSP.
@@ -136,6 +137,21 @@
  */
 #define TSP_NUM_ARGS	0x2
 
+/*
+ * Groups of EL1 system registers switched on the fast SMC path with
+ * TSPD_DIRECT_FAST_SMC. Every group which the TSP or the hardware may write
+ * while the TSP runs is included, e.g. AFSR0/1_EL1 may be written by any abort
+ * taken to S-EL1. Only the timer group, switched with NS_TIMER_SWITCH, is left
+ * out: the TSP only uses the secure physical timer (CNTPS_*_EL1) and never
+ * accesses CNTP_*, CNTV_* or CNTKCTL_EL1. A secure payload which uses those
+ * must define this set with the timer group added. The set must always include
+ * the registers which isolate S-EL1 from the normal world (see tspd_main.c).
+ */
+#ifndef TSPD_FAST_SMC_EL1_SYSREGS
+#define TSPD_FAST_SMC_EL1_SYSREGS	(CTX_EL1_ALL_REGS &			\
+					 ~BIT_32(CTX_EL1_TIMER_BIT))
+#endif
+
 /* AArch64 callee saved general purpose register context structure. */
 DEFINE_REG_STRUCT(c_rt_regs, TSPD_C_RT_CTX_ENTRIES);
 
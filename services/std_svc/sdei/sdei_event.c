@@ -10,6 +10,15 @@
 
 #define MAP_OFF(_map, _mapping) ((_map) - (_mapping)->map)
 
+/*
+ * Index of the event mappings by interrupt number, used to find the event bound
+ * to an interrupt in constant time on dispatch. Each element holds the offset,
+ * plus one, of the mapping in the private or shared array as applicable, or 0
+ * when no event is bound to the interrupt. Private and shared events are bound
+ * to disjoint ranges of interrupts, so they share the same index.
+ */
+static uint16_t sdei_intr_index[PLAT_SDEI_MAX_INTR_ID + 1];
+
 /*
  * Get SDEI entry with the given mapping: on success, returns pointer to SDEI
  * entry. On error, returns NULL.
@@ -48,6 +57,36 @@ sdei_entry_t *get_event_entry(sdei_ev_map_t *map)
 	}
 }
 
+/*
+ * Record in the interrupt index that the event mapping is bound to its
+ * interrupt.
+ */
+void sdei_intr_index_set(sdei_ev_map_t *map)
+{
+	const sdei_mapping_t *mapping;
+
+	if ((map->intr == SDEI_DYN_IRQ) || (map->intr > PLAT_SDEI_MAX_INTR_ID))
+		return;
+
+	mapping = is_event_private(map) ? SDEI_PRIVATE_MAPPING() :
+		SDEI_SHARED_MAPPING();
+	assert(mapping->num_maps < UINT16_MAX);
+
+	sdei_intr_index[map->intr] = MAP_OFF(map, mapping) + 1;
+}
+
+/*
+ * Remove the binding of the event mapping to its interrupt from the interrupt
+ * index.
+ */
+void sdei_intr_index_clear(sdei_ev_map_t *map)
+{
+	if ((map->intr == SDEI_DYN_IRQ) || (map->intr > PLAT_SDEI_MAX_INTR_ID))
+		return;
+
+	sdei_intr_index[map->intr] = 0;
+}
+
 /*
  * Find event mapping for a given interrupt number: On success, returns pointer
  * to the event mapping. On error, returns NULL.
@@ -56,14 +95,25 @@ sdei_ev_map_t *find_event_map_by_intr(int intr_num, int shared)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i;
+	unsigned int i, idx;
+
+	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
 
 	/*
-	 * Look for a match in private and shared mappings, as requested. This
-	 * is a linear search. However, if the mappings are required to be
-	 * sorted, for large maps, we could consider binary search.
+	 * Bound interrupts are looked up in the index. Free dynamic mappings
+	 * all have their interrupt set as SDEI_DYN_IRQ, so search them, as well
+	 * as interrupts beyond the index, linearly.
 	 */
-	mapping = shared ? SDEI_SHARED_MAPPING() : SDEI_PRIVATE_MAPPING();
+	if ((intr_num != SDEI_DYN_IRQ) && (intr_num >= 0) &&
+	    (intr_num <= PLAT_SDEI_MAX_INTR_ID)) {
+		idx = sdei_intr_index[intr_num];
+		if ((idx == 0) || (idx > mapping->num_maps))
+			return NULL;
+
+		map = &mapping->map[idx - 1];
+		return (map->intr == intr_num) ? map : NULL;
+	}
+
 	iterate_mapping(mapping, i, map) {
 		if (map->intr == intr_num)
 			return map;
@@ -80,17 +130,26 @@ sdei_ev_map_t *find_event_map(int ev_num)
 {
 	const sdei_mapping_t *mapping;
 	sdei_ev_map_t *map;
-	unsigned int i, j;
+	unsigned int i, lo, hi, mid;
 
 	/*
-	 * Iterate through mappings to find a match. This is a linear search.
-	 * However, if the mappings are required to be sorted, for large maps,
-	 * we could consider binary search.
+	 * The mappings are required to be sorted in increasing order of event
+	 * number, so binary search each of them.
 	 */
 	for_each_mapping_type(i, mapping) {
-		iterate_mapping(mapping, j, map) {
+		lo = 0;
+		hi = mapping->num_maps;
+		while (lo < hi) {
+			mid = lo + ((hi - lo) / 2);
+			map = &mapping->map[mid];
+
 			if (map->ev_num == ev_num)
 				return map;
+
+			if (map->ev_num < ev_num)
+				lo = mid + 1;
+			else
+				hi = mid;
 		}
 	}
 
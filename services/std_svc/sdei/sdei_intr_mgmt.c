@@ -42,6 +42,11 @@ typedef struct sdei_dispatch_context {
 	/* CVE-2018-3639 mitigation state */
 	uint64_t disable_cve_2018_3639;
 #endif
+
+#if SDEI_STATS
+	/* Time of entry into the client handler */
+	uint64_t dispatch_ts;
+#endif
 } sdei_dispatch_context_t;
 
 /* Per-CPU SDEI state data */
@@ -233,10 +238,11 @@ static cpu_context_t *restore_and_resume_ns_context(void)
 
 /*
  * Populate the Non-secure context so that the next ERET will dispatch to the
- * SDEI client.
+ * SDEI client. 'trigger_ts' is the time at which the event was triggered.
  */
 static void setup_ns_dispatch(sdei_ev_map_t *map, sdei_entry_t *se,
-		cpu_context_t *ctx, struct jmpbuf *dispatch_jmp)
+		cpu_context_t *ctx, struct jmpbuf *dispatch_jmp,
+		uint64_t trigger_ts __unused)
 {
 	sdei_dispatch_context_t *disp_ctx;
 
@@ -279,6 +285,11 @@ static void setup_ns_dispatch(sdei_ev_map_t *map, sdei_entry_t *se,
 #endif
 
 	disp_ctx->dispatch_jmp = dispatch_jmp;
+
+#if SDEI_STATS
+	disp_ctx->dispatch_ts = sdei_stats_dispatched(map, trigger_ts,
+			sdei_get_this_pe_state()->stack_top > 1);
+#endif
 }
 
 /* Handle a triggered SDEI interrupt while events were masked on this PE */
@@ -349,6 +360,7 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 	sdei_cpu_state_t *state;
 	uint32_t intr;
 	struct jmpbuf dispatch_jmp;
+	uint64_t trigger_ts = sdei_stats_timestamp();
 
 	/*
 	 * To handle an event, the following conditions must be true:
@@ -400,6 +412,9 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 			sdei_map_lock(map);
 
 		handle_masked_trigger(map, se, state, intr_raw);
+#if SDEI_STATS
+		sdei_stats_deferred(map);
+#endif
 
 		if (is_event_shared(map))
 			sdei_map_unlock(map);
@@ -483,7 +498,7 @@ int sdei_intr_handler(uint32_t intr_raw, uint32_t flags, void *handle,
 	}
 
 	/* Synchronously dispatch event */
-	setup_ns_dispatch(map, se, ctx, &dispatch_jmp);
+	setup_ns_dispatch(map, se, ctx, &dispatch_jmp, trigger_ts);
 	begin_sdei_synchronous_dispatch(&dispatch_jmp);
 
 	/*
@@ -536,6 +551,7 @@ int sdei_dispatch_event(int ev_num)
 	sdei_dispatch_context_t *disp_ctx;
 	sdei_cpu_state_t *state;
 	struct jmpbuf dispatch_jmp;
+	uint64_t trigger_ts = sdei_stats_timestamp();
 
 	/* Can't dispatch if events are masked on this PE */
 	state = sdei_get_this_pe_state();
@@ -587,7 +603,7 @@ int sdei_dispatch_event(int ev_num)
 	ns_ctx = restore_and_resume_ns_context();
 
 	/* Dispatch event synchronously */
-	setup_ns_dispatch(map, se, ns_ctx, &dispatch_jmp);
+	setup_ns_dispatch(map, se, ns_ctx, &dispatch_jmp, trigger_ts);
 	begin_sdei_synchronous_dispatch(&dispatch_jmp);
 
 	/*
@@ -638,6 +654,10 @@ int sdei_event_complete(int resume, uint64_t pc)
 	/* Having done sanity checks, pop dispatch */
 	pop_dispatch();
 
+#if SDEI_STATS
+	sdei_stats_completed(map, disp_ctx->dispatch_ts);
+#endif
+
 	SDEI_LOG("EOI:%lx, %d spsr:%lx elr:%lx\n", read_mpidr_el1(),
 			map->ev_num, read_spsr_el3(), read_elr_el3());
 
@@ -12,14 +12,19 @@
 #include <context.h>
 #include <debug.h>
 #include <ehf.h>
+#include <errno.h>
 #include <interrupt_mgmt.h>
 #include <platform.h>
+#include <platform_def.h>
 #include <pubsub.h>
 #include <runtime_svc.h>
 #include <sdei.h>
 #include <stddef.h>
 #include <string.h>
 #include <utils.h>
+#if PLAT_XLAT_TABLES_DYNAMIC
+#include <xlat_tables_v2.h>
+#endif
 #include "sdei_private.h"
 
 #define MAJOR_VERSION	1
@@ -128,6 +133,7 @@ void sdei_class_init(sdei_class_t class)
 			/* Shared mappings must be bound to shared interrupt */
 			assert(plat_ic_is_spi(map->intr));
 			set_map_bound(map);
+			sdei_intr_index_set(map);
 		}
 
 		init_map(map);
@@ -202,6 +208,9 @@ void sdei_class_init(sdei_class_t class)
 			}
 		}
 
+		/* Index the bound interrupts, including the SGI of event 0 */
+		sdei_intr_index_set(map);
+
 		init_map(map);
 	}
 
@@ -727,6 +736,7 @@ static int sdei_interrupt_bind(int intr_num)
 		if (!is_map_bound(map)) {
 			map->intr = intr_num;
 			set_map_bound(map);
+			sdei_intr_index_set(map);
 			retry = 0;
 		}
 		sdei_map_unlock(map);
@@ -784,6 +794,7 @@ static int sdei_interrupt_release(int ev_num)
 		 * during unregister.
 		 */
 
+		sdei_intr_index_clear(map);
 		map->intr = SDEI_DYN_IRQ;
 		clr_map_bound(map);
 	} else {
@@ -905,6 +916,168 @@ uint64_t sdei_features(unsigned int feature)
 	return SDEI_EINVAL;
 }
 
+#if PLAT_XLAT_TABLES_DYNAMIC
+/* Number of descriptors of SDEI_SIP_EVENT_BATCH copied at a time */
+#define SDEI_BATCH_CHUNK	8
+
+/*
+ * Return whether the pages of the range are already mapped in EL3 as writable
+ * Non-secure memory, with VA == PA.
+ */
+static int sdei_batch_is_mapped(uintptr_t base, size_t size)
+{
+	u_register_t saved_par, par;
+	uintptr_t va;
+	int mapped = 1;
+
+	/* PAR_EL1 belongs to the Non-secure world */
+	saved_par = read_par_el1();
+
+	for (va = base; va < (base + size); va += PAGE_SIZE) {
+		ats1e3w(va);
+		isb();
+		par = read_par_el1();
+		if (((par & PAR_F_MASK) != 0U) || ((par & PAR_NS_BIT) == 0U) ||
+				((par & (PAR_ADDR_MASK << PAR_ADDR_SHIFT)) !=
+				 va)) {
+			mapped = 0;
+			break;
+		}
+	}
+
+	write_par_el1(saved_par);
+
+	return mapped;
+}
+
+/*
+ * Copy 'n' descriptors, starting at 'index', from the Non-secure list at 'list'
+ * into 'descs' or, if 'write_result' is set, write back their 'result' field.
+ * The list is mapped into EL3 for the duration of the copy, unless it is
+ * already mapped.
+ */
+static int sdei_batch_copy(uintptr_t list, unsigned int index,
+		sdei_batch_desc_t *descs, unsigned int n, int write_result)
+{
+	volatile sdei_batch_desc_t *ns_descs;
+	uintptr_t base, map_base;
+	size_t map_size;
+	unsigned int i;
+	int ret, mapped;
+
+	base = list + (index * sizeof(*descs));
+	map_base = round_down(base, PAGE_SIZE);
+	map_size = round_up(base + (n * sizeof(*descs)), PAGE_SIZE) - map_base;
+
+	/*
+	 * The lock shared with the other users of the dynamic regions is held
+	 * during the copy, so that a region the list lies in can't be removed
+	 * under our feet. It isn't held while the events are processed.
+	 */
+	bl31_ns_mem_lock_acquire();
+
+	ret = bl31_map_ns_mem(map_base, map_size);
+	mapped = (ret == 0);
+
+	/* The list may lie in a region which is already mapped */
+	if ((ret == -EPERM) && sdei_batch_is_mapped(map_base, map_size))
+		ret = 0;
+
+	if (ret != 0) {
+		bl31_ns_mem_lock_release();
+		return SDEI_EINVAL;
+	}
+
+	ns_descs = (volatile sdei_batch_desc_t *) base;
+	for (i = 0; i < n; i++) {
+		if (write_result != 0) {
+			ns_descs[i].result = descs[i].result;
+			continue;
+		}
+
+		/* Copy the descriptor so that it can't change under our feet */
+		descs[i].ev_num = ns_descs[i].ev_num;
+		descs[i].ep = ns_descs[i].ep;
+		descs[i].arg = ns_descs[i].arg;
+		descs[i].flags = ns_descs[i].flags;
+		descs[i].affinity = ns_descs[i].affinity;
+	}
+
+	if (mapped != 0) {
+		ret = bl31_unmap_ns_mem(map_base, map_size);
+		assert(ret == 0);
+	}
+
+	bl31_ns_mem_lock_release();
+
+	return 0;
+}
+
+/* Apply the requested operations to the event described by 'desc' */
+static int sdei_event_batch_one(const sdei_batch_desc_t *desc,
+		unsigned int ops)
+{
+	int ret = 0;
+
+	if ((ops & SDEI_BATCH_OP_REGISTER) != 0U) {
+		ret = sdei_event_register(desc->ev_num, desc->ep, desc->arg,
+				desc->flags, desc->affinity);
+		if (ret)
+			return ret;
+	}
+
+	if ((ops & SDEI_BATCH_OP_ROUTING_SET) != 0U) {
+		ret = sdei_event_routing_set(desc->ev_num, desc->flags,
+				desc->affinity);
+		if (ret)
+			return ret;
+	}
+
+	if ((ops & SDEI_BATCH_OP_ENABLE) != 0U)
+		ret = sdei_event_enable(desc->ev_num);
+
+	return ret;
+}
+
+/*
+ * Apply the operations 'ops' to each of the 'count' events described in the
+ * Non-secure memory at 'base', stopping at the first failure. Returns the
+ * number of events for which all operations succeeded.
+ */
+static int64_t sdei_event_batch(uint64_t base, uint64_t count, uint64_t ops)
+{
+	sdei_batch_desc_t descs[SDEI_BATCH_CHUNK];
+	unsigned int i, n;
+	int64_t done;
+
+	if ((count == 0) || (count > SDEI_BATCH_MAX_DESCS) ||
+			(ops == 0) || ((ops & ~SDEI_BATCH_OP_MASK) != 0) ||
+			((base & (sizeof(uint64_t) - 1)) != 0) ||
+			check_uptr_overflow(base, count * sizeof(descs[0])))
+		return SDEI_EINVAL;
+
+	for (done = 0; done < (int64_t) count; done += n) {
+		n = count - done;
+		if (n > SDEI_BATCH_CHUNK)
+			n = SDEI_BATCH_CHUNK;
+
+		if (sdei_batch_copy(base, done, descs, n, 0) != 0)
+			return SDEI_EINVAL;
+
+		for (i = 0; i < n; i++) {
+			descs[i].result = sdei_event_batch_one(&descs[i], ops);
+			if (descs[i].result != 0) {
+				(void) sdei_batch_copy(base, done + i,
+						&descs[i], 1, 1);
+				return done + i;
+			}
+		}
+	}
+
+	return done;
+}
+#endif /* PLAT_XLAT_TABLES_DYNAMIC */
+
 /* SDEI top level handler for servicing SMCs */
 uint64_t sdei_smc_handler(uint32_t smc_fid,
 			  uint64_t x1,
@@ -1063,5 +1236,51 @@ uint64_t sdei_smc_handler(uint32_t smc_fid,
 	SMC_RET1(handle, SMC_UNK);
 }
 
+/* SDEI handler for the SiP calls, called by the SiP service of the platform */
+uint64_t sdei_sip_smc_handler(uint32_t smc_fid,
+			      uint64_t x1,
+			      uint64_t x2,
+			      uint64_t x3,
+			      uint64_t x4,
+			      void *cookie,
+			      void *handle,
+			      uint64_t flags)
+{
+	int ss = get_interrupt_src_ss(flags);
+	int64_t ret __unused;
+
+	if (ss != NON_SECURE)
+		SMC_RET1(handle, SMC_UNK);
+
+	/* Verify the caller EL */
+	if (GET_EL(read_spsr_el3()) != sdei_client_el())
+		SMC_RET1(handle, SMC_UNK);
+
+	switch (smc_fid) {
+#if PLAT_XLAT_TABLES_DYNAMIC
+	case SDEI_SIP_EVENT_BATCH:
+		SDEI_LOG("> BATCH(b:%llx n:%llu o:%llx)\n", x1, x2, x3);
+		ret = sdei_event_batch(x1, x2, x3);
+		SDEI_LOG("< BATCH:%lld\n", ret);
+		SMC_RET1(handle, ret);
+#endif
+
+#if SDEI_STATS
+	case SDEI_SIP_EVENT_STATS_GET:
+		SDEI_LOG("> STATS(n:%d t:%llx s:%llx)\n", (int) x1, x2, x3);
+		ret = sdei_stats_get(x1, x2, x3);
+		SDEI_LOG("< STATS:%lld\n", ret);
+		SMC_RET1(handle, ret);
+#endif
+
+	default:
+		/* Do nothing in default case */
+		break;
+	}
+
+	WARN("Unimplemented SDEI SiP Call: 0x%x\n", smc_fid);
+	SMC_RET1(handle, SMC_UNK);
+}
+
 /* Subscribe to PSCI CPU on to initialize per-CPU SDEI configuration */
 SUBSCRIBE_TO_EVENT(psci_cpu_on_finish, sdei_cpu_on_init);
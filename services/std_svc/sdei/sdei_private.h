@@ -32,6 +32,15 @@
 # error Platform must define SDEI normal priority value
 #endif
 
+/*
+ * Highest interrupt number indexed for constant time lookup of the event bound
+ * to an interrupt. Events bound to interrupts above it are searched linearly.
+ * The default covers all GIC SGIs, PPIs and SPIs.
+ */
+#ifndef PLAT_SDEI_MAX_INTR_ID
+# define PLAT_SDEI_MAX_INTR_ID		1019
+#endif
+
 /* Output SDEI logs as verbose */
 #define SDEI_LOG(...)	VERBOSE("SDEI: " __VA_ARGS__)
 
@@ -230,8 +239,28 @@ void init_sdei_state(void);
 
 sdei_ev_map_t *find_event_map_by_intr(int intr_num, int shared);
 sdei_ev_map_t *find_event_map(int ev_num);
+void sdei_intr_index_set(sdei_ev_map_t *map);
+void sdei_intr_index_clear(sdei_ev_map_t *map);
 sdei_entry_t *get_event_entry(sdei_ev_map_t *map);
 
+#if SDEI_STATS
+void sdei_stats_deferred(sdei_ev_map_t *map);
+uint64_t sdei_stats_dispatched(sdei_ev_map_t *map, uint64_t trigger_ts,
+		int nested);
+void sdei_stats_completed(sdei_ev_map_t *map, uint64_t dispatch_ts);
+int64_t sdei_stats_get(int ev_num, uint64_t target_pe, unsigned int stat);
+#endif
+
+/* Timestamp of an event trigger, for the dispatch statistics */
+static inline uint64_t sdei_stats_timestamp(void)
+{
+#if SDEI_STATS
+	return read_cntpct_el0();
+#else
+	return 0;
+#endif
+}
+
 int sdei_event_context(void *handle, unsigned int param);
 int sdei_event_complete(int resume, uint64_t arg);
 
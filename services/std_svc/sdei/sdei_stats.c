@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <arch_helpers.h>
+#include <assert.h>
+#include <platform.h>
+#include <sdei.h>
+#include "sdei_private.h"
+
+/*
+ * Dispatch statistics of the events. As for the event entries, the statistics
+ * of each CPU are stored at the same index as the mapping of the event in the
+ * private or shared array. Only the owning CPU updates its statistics, so no
+ * locking is required.
+ */
+extern sdei_ev_stats_t sdei_private_event_stats[];
+extern sdei_ev_stats_t sdei_shared_event_stats[];
+
+static sdei_ev_stats_t *get_event_stats(sdei_ev_map_t *map, unsigned int cpu)
+{
+	const sdei_mapping_t *mapping;
+	sdei_ev_stats_t *stats;
+
+	if (is_event_private(map)) {
+		mapping = SDEI_PRIVATE_MAPPING();
+		stats = sdei_private_event_stats;
+	} else {
+		mapping = SDEI_SHARED_MAPPING();
+		stats = sdei_shared_event_stats;
+	}
+
+	return &stats[(cpu * mapping->num_maps) + (map - mapping->map)];
+}
+
+/* Histogram bin of a latency, in system counter ticks */
+static unsigned int latency_bin(uint64_t ticks)
+{
+	unsigned int bin = 0;
+
+	while ((ticks != 0U) && (bin < (SDEI_STATS_HIST_BINS - 1))) {
+		ticks >>= 1;
+		bin++;
+	}
+
+	return bin;
+}
+
+/* An interrupt for the event was deferred as events were masked on this CPU */
+void sdei_stats_deferred(sdei_ev_map_t *map)
+{
+	get_event_stats(map, plat_my_core_pos())->deferred++;
+}
+
+/*
+ * The event, triggered at 'trigger_ts', is being dispatched on this CPU,
+ * possibly preempting an outstanding dispatch. Returns the dispatch timestamp.
+ */
+uint64_t sdei_stats_dispatched(sdei_ev_map_t *map, uint64_t trigger_ts,
+		int nested)
+{
+	sdei_ev_stats_t *stats = get_event_stats(map, plat_my_core_pos());
+	uint64_t now = read_cntpct_el0();
+
+	stats->dispatched++;
+	if (nested)
+		stats->nested++;
+	stats->trig_to_disp[latency_bin(now - trigger_ts)]++;
+
+	return now;
+}
+
+/* The client completed the event dispatched at 'dispatch_ts' on this CPU */
+void sdei_stats_completed(sdei_ev_map_t *map, uint64_t dispatch_ts)
+{
+	sdei_ev_stats_t *stats = get_event_stats(map, plat_my_core_pos());
+
+	stats->disp_to_comp[latency_bin(read_cntpct_el0() - dispatch_ts)]++;
+}
+
+/* Return one of the dispatch statistics of an event on the given CPU */
+int64_t sdei_stats_get(int ev_num, uint64_t target_pe, unsigned int stat)
+{
+	sdei_ev_stats_t *stats;
+	sdei_ev_map_t *map;
+	unsigned int bin;
+	int cpu;
+
+	map = find_event_map(ev_num);
+	if (map == NULL)
+		return SDEI_EINVAL;
+
+	cpu = plat_core_pos_by_mpidr(target_pe);
+	if (cpu < 0)
+		return SDEI_EINVAL;
+
+	stats = get_event_stats(map, cpu);
+
+	switch (stat) {
+	case SDEI_STATS_DISPATCHED:
+		return stats->dispatched;
+	case SDEI_STATS_DEFERRED:
+		return stats->deferred;
+	case SDEI_STATS_NESTED:
+		return stats->nested;
+	default:
+		break;
+	}
+
+	bin = stat & 0xff;
+	if (bin >= SDEI_STATS_HIST_BINS)
+		return SDEI_EINVAL;
+
+	if (stat == SDEI_STATS_TRIG_TO_DISP(bin))
+		return stats->trig_to_disp[bin];
+	if (stat == SDEI_STATS_DISP_TO_COMP(bin))
+		return stats->disp_to_comp[bin];
+
+	return SDEI_EINVAL;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2015-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -7,9 +7,12 @@
 #include <assert.h>
 #include <ctype.h>
 #include <getopt.h>
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
+#include <unistd.h>
 
 #include <openssl/conf.h>
 #include <openssl/engine.h>
@@ -60,11 +63,36 @@
 		} \
 	} while (0)
 
+/*
+ * Variants of CHECK_NULL and CHECK_OID for the worker threads, which make the
+ * work item fail instead of exiting: they jump to its 'job_error' label, where
+ * it releases what it has allocated.
+ */
+#define JOB_CHECK_NULL(v, fn) \
+	do { \
+		v = fn; \
+		if (v == NULL) { \
+			ERROR("NULL object at %s:%d\n", __FILE__, __LINE__); \
+			goto job_error; \
+		} \
+	} while (0)
+
+#define JOB_CHECK_OID(v, oid) \
+	do { \
+		v = OBJ_txt2nid(oid); \
+		if (v == NID_undef) { \
+			ERROR("Cannot find TBB extension %s\n", oid); \
+			goto job_error; \
+		} \
+	} while (0)
+
 #define MAX_FILENAME_LEN		1024
 #define VAL_DAYS			7300
 #define ID_TO_BIT_MASK(id)		(1 << id)
 #define NUM_ELEM(x)			((sizeof(x)) / (sizeof(x[0])))
 #define HELP_OPT_MAX_LEN		128
+#define MANIFEST_LINE_LEN		8192
+#define MANIFEST_MAX_ARGS		(CMD_OPT_MAX_NUM * 2 + 1)
 
 /* Global options */
 static int key_alg;
@@ -72,20 +100,74 @@ static int hash_alg;
 static int new_keys;
 static int save_keys;
 static int print_cert;
+static int print_stats;
+static int num_jobs;
+static const char *manifest_fn;
+
+/* Hash algorithm used in the image hash extensions */
+static const EVP_MD *md_info;
+static unsigned int md_len;
+
+/*
+ * Keys loaded from the batch manifest. They are cached by filename so that
+ * each key file is only loaded once for all the configurations.
+ */
+typedef struct key_cache_s {
+	char *fn;
+	EVP_PKEY *key;
+	struct key_cache_s *next;
+} key_cache_t;
+
+static key_cache_t *key_cache;
+
+/* Configurations listed in the batch manifest, in order */
+typedef struct batch_cfg_s {
+	int lineno;
+	int argc;
+	char **argv;
+	struct batch_cfg_s *next;
+} batch_cfg_t;
+
+static batch_cfg_t *batch_cfgs;
+
+/*
+ * Keys given by every configuration of the batch manifest, which therefore
+ * don't need to be loaded from the command line
+ */
+static unsigned char *batch_keys;
+
+/* Work queue shared by the worker threads */
+static struct {
+	pthread_mutex_t lock;
+	pthread_cond_t cond;
+	unsigned int num;	/* Number of work items */
+	unsigned int next;	/* Next work item to hand out */
+	unsigned int done;	/* Number of completed work items */
+	int failed;		/* A work item has failed */
+	unsigned char *state;	/* State of each work item */
+	int (*ready)(unsigned int idx, const unsigned char *state);
+	int (*work)(unsigned int idx);
+} job_queue = {
+	.lock = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER
+};
+
+enum {
+	JOB_PENDING,
+	JOB_RUNNING,
+	JOB_DONE
+};
 
 /* Info messages created in the Makefile */
 extern const char build_msg[];
 extern const char platform_msg[];
 
-
-static char *strdup(const char *str)
+static double get_time(void)
 {
-	int n = strlen(str) + 1;
-	char *dup = malloc(n);
-	if (dup) {
-		strcpy(dup, str);
-	}
-	return dup;
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
 }
 
 static const char *key_algs_str[] = {
@@ -260,25 +342,557 @@ PKCS#1 v2.1, 'rsa_1_5' - RSA PKCS#1 v1.5, 'ecdsa'"
 	{
 		{ "print-cert", no_argument, NULL, 'p' },
 		"Print the certificates in the standard output"
+	},
+	{
+		{ "batch", required_argument, NULL, 'b' },
+		"Create the certificates of every configuration listed in the \
+given manifest file, one configuration per line. Each line contains the \
+certificate, image, counter and key options of one configuration. Keys that \
+are not listed are taken from the command line and shared by all the \
+configurations"
+	},
+	{
+		{ "jobs", required_argument, NULL, 'j' },
+		"Number of keys and certificates created in parallel (default: \
+number of CPUs)"
+	},
+	{
+		{ "stats", no_argument, NULL, 't' },
+		"Print timing statistics"
 	}
 };
 
-int main(int argc, char *argv[])
+/*
+ * Run the work items of the job queue on a pool of worker threads. A work item
+ * is only handed out once the 'ready' callback reports that the items it
+ * depends on are complete. No more items are handed out once one has failed.
+ */
+static void *job_worker(void *arg)
+{
+	unsigned int i;
+	int found, ret;
+
+	pthread_mutex_lock(&job_queue.lock);
+	while (!job_queue.failed && job_queue.done < job_queue.num) {
+		found = 0;
+		for (i = job_queue.next; i < job_queue.num; i++) {
+			if (job_queue.state[i] == JOB_PENDING &&
+			    job_queue.ready(i, job_queue.state)) {
+				found = 1;
+				break;
+			}
+		}
+		if (!found) {
+			/* Wait for a dependency to complete */
+			if (job_queue.next == job_queue.num) {
+				break;
+			}
+			pthread_cond_wait(&job_queue.cond, &job_queue.lock);
+			continue;
+		}
+
+		job_queue.state[i] = JOB_RUNNING;
+		while (job_queue.next < job_queue.num &&
+		       job_queue.state[job_queue.next] != JOB_PENDING) {
+			job_queue.next++;
+		}
+		pthread_mutex_unlock(&job_queue.lock);
+
+		ret = job_queue.work(i);
+
+		pthread_mutex_lock(&job_queue.lock);
+		if (ret != 0) {
+			job_queue.failed = 1;
+		}
+		job_queue.state[i] = JOB_DONE;
+		job_queue.done++;
+		pthread_cond_broadcast(&job_queue.cond);
+	}
+	pthread_mutex_unlock(&job_queue.lock);
+
+	return NULL;
+}
+
+static int job_always_ready(unsigned int idx, const unsigned char *state)
+{
+	return 1;
+}
+
+/*
+ * Run 'num' work items. If any of them fails, exit once all the workers have
+ * stopped, so that no thread is still using OpenSSL.
+ */
+static void run_jobs(unsigned int num,
+		     int (*ready)(unsigned int idx, const unsigned char *state),
+		     int (*work)(unsigned int idx))
+{
+	pthread_t threads[num];
+	unsigned int i, num_threads;
+
+	job_queue.num = num;
+	job_queue.next = 0;
+	job_queue.done = 0;
+	job_queue.failed = 0;
+	job_queue.ready = ready;
+	job_queue.work = work;
+	CHECK_NULL(job_queue.state, calloc(num, 1));
+
+	num_threads = ((unsigned int)num_jobs < num) ? num_jobs : num;
+	if (num_threads <= 1) {
+		job_worker(NULL);
+	} else {
+		for (i = 0; i < num_threads; i++) {
+			if (pthread_create(&threads[i], NULL, job_worker,
+					   NULL) != 0) {
+				ERROR("Cannot create worker thread\n");
+				exit(1);
+			}
+		}
+		for (i = 0; i < num_threads; i++) {
+			pthread_join(threads[i], NULL);
+		}
+	}
+
+	free(job_queue.state);
+	job_queue.state = NULL;
+
+	if (job_queue.failed) {
+		exit(1);
+	}
+}
+
+/*
+ * Load a private key from its file or create a new one
+ */
+static int load_key(unsigned int i)
 {
-	STACK_OF(X509_EXTENSION) * sk;
-	X509_EXTENSION *cert_ext = NULL;
+	unsigned int err_code;
+
+	/* Keys given by every configuration of the batch are loaded there */
+	if (batch_keys != NULL && batch_keys[i] && keys[i].fn == NULL) {
+		return 0;
+	}
+
+	/* First try to load the key from disk */
+	if (key_load(&keys[i], &err_code)) {
+		/* Key loaded successfully */
+		return 0;
+	}
+
+	/* Key not loaded. Check the error code */
+	if (err_code == KEY_ERR_LOAD) {
+		/* File exists, but it does not contain a valid private
+		 * key. Abort. */
+		ERROR("Error loading '%s'\n", keys[i].fn);
+		return -1;
+	}
+
+	/* File does not exist, could not be opened or no filename was
+	 * given */
+	if (new_keys) {
+		/* Try to create a new key */
+		NOTICE("Creating new key for '%s'\n", keys[i].desc);
+		if (!key_create(&keys[i], key_alg)) {
+			ERROR("Error creating key '%s'\n", keys[i].desc);
+			return -1;
+		}
+	} else {
+		if (err_code == KEY_ERR_OPEN) {
+			ERROR("Error opening '%s'\n", keys[i].fn);
+		} else {
+			ERROR("Key '%s' not specified\n", keys[i].desc);
+		}
+		return -1;
+	}
+
+	return 0;
+}
+
+/*
+ * Create a certificate. Signed with corresponding key
+ */
+static int create_cert(unsigned int i)
+{
+	STACK_OF(X509_EXTENSION) * sk = NULL;
+	X509_EXTENSION *cert_ext;
+	cert_t *cert = &certs[i];
+	ext_t *ext;
+	int j, ext_nid, nvctr;
+	unsigned char md[SHA512_DIGEST_LENGTH];
+
+	/* Create a new stack of extensions. This stack will be used
+	 * to create the certificate */
+	JOB_CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
+
+	for (j = 0 ; j < cert->num_ext ; j++) {
+
+		ext = &extensions[cert->ext[j]];
+		cert_ext = NULL;
+
+		/* Get OpenSSL internal ID for this extension */
+		JOB_CHECK_OID(ext_nid, ext->oid);
+
+		/*
+		 * Three types of extensions are currently supported:
+		 *     - EXT_TYPE_NVCOUNTER
+		 *     - EXT_TYPE_HASH
+		 *     - EXT_TYPE_PKEY
+		 */
+		switch (ext->type) {
+		case EXT_TYPE_NVCOUNTER:
+			if (ext->arg) {
+				nvctr = atoi(ext->arg);
+				JOB_CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
+					EXT_CRIT, nvctr));
+			}
+			break;
+		case EXT_TYPE_HASH:
+			if (ext->arg == NULL) {
+				if (ext->optional) {
+					/* Include a hash filled with zeros */
+					memset(md, 0x0, SHA512_DIGEST_LENGTH);
+				} else {
+					/* Do not include this hash in the certificate */
+					break;
+				}
+			} else {
+				/* Calculate the hash of the file */
+				if (!sha_file(hash_alg, ext->arg, md)) {
+					ERROR("Cannot calculate hash of %s\n",
+						ext->arg);
+					goto job_error;
+				}
+			}
+			JOB_CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
+					EXT_CRIT, md_info, md,
+					md_len));
+			break;
+		case EXT_TYPE_PKEY:
+			JOB_CHECK_NULL(cert_ext, ext_new_key(ext_nid,
+				EXT_CRIT, keys[ext->attr.key].key));
+			break;
+		default:
+			ERROR("Unknown extension type '%d' in %s\n",
+					ext->type, cert->cn);
+			goto job_error;
+		}
+
+		/* Push the extension into the stack, unless it is left out */
+		if (cert_ext != NULL &&
+		    sk_X509_EXTENSION_push(sk, cert_ext) == 0) {
+			X509_EXTENSION_free(cert_ext);
+			ERROR("Cannot add extension to %s\n", cert->cn);
+			goto job_error;
+		}
+	}
+
+	/* Create certificate. Signed with corresponding key */
+	if (cert->fn && !cert_new(key_alg, hash_alg, cert, VAL_DAYS, 0, sk)) {
+		ERROR("Cannot create %s\n", cert->cn);
+		goto job_error;
+	}
+
+	/* The certificate holds copies of the extensions */
+	sk_X509_EXTENSION_pop_free(sk, X509_EXTENSION_free);
+
+	return 0;
+
+job_error:
+	sk_X509_EXTENSION_pop_free(sk, X509_EXTENSION_free);
+
+	return -1;
+}
+
+/* A certificate can be created once its issuer certificate exists */
+static int cert_ready(unsigned int i, const unsigned char *state)
+{
+	unsigned int issuer = certs[i].issuer;
+
+	return (issuer == i) || (state[issuer] == JOB_DONE);
+}
+
+/*
+ * Create, print and save the certificates of the current configuration
+ */
+static void create_certs(void)
+{
+	double t = get_time();
+	int i;
+
+	run_jobs(num_certs, cert_ready, create_cert);
+
+	if (print_stats) {
+		NOTICE("Certificates created in %.3fs\n", get_time() - t);
+	}
+
+	/* Print the certificates */
+	if (print_cert) {
+		for (i = 0 ; i < num_certs ; i++) {
+			if (!certs[i].x) {
+				continue;
+			}
+			printf("\n\n=====================================\n\n");
+			X509_print_fp(stdout, certs[i].x);
+		}
+	}
+
+	/* Save created certificates to files */
+	for (i = 0 ; i < num_certs ; i++) {
+		if (certs[i].x && certs[i].fn) {
+			FILE *file = fopen(certs[i].fn, "w");
+			if (file != NULL) {
+				i2d_X509_fp(file, certs[i].x);
+				fclose(file);
+			} else {
+				ERROR("Cannot create file %s\n", certs[i].fn);
+			}
+		}
+	}
+}
+
+/*
+ * Handle the options that describe a configuration: certificate filenames,
+ * extension values and key filenames
+ */
+static int set_cot_opt(int c, int opt_idx, const char *arg)
+{
+	const char *cur_opt;
 	ext_t *ext;
 	key_t *key;
 	cert_t *cert;
-	FILE *file;
-	int i, j, ext_nid, nvctr;
+
+	switch (c) {
+	case CMD_OPT_EXT:
+		cur_opt = cmd_opt_get_name(opt_idx);
+		ext = ext_get_by_opt(cur_opt);
+		free((void *)ext->arg);
+		ext->arg = strdup(arg);
+		break;
+	case CMD_OPT_KEY:
+		cur_opt = cmd_opt_get_name(opt_idx);
+		key = key_get_by_opt(cur_opt);
+		key->fn = strdup(arg);
+		break;
+	case CMD_OPT_CERT:
+		cur_opt = cmd_opt_get_name(opt_idx);
+		cert = cert_get_by_opt(cur_opt);
+		free((void *)cert->fn);
+		cert->fn = strdup(arg);
+		break;
+	default:
+		return 0;
+	}
+
+	return 1;
+}
+
+/*
+ * Get a key loaded from the manifest, loading it on first use
+ */
+static EVP_PKEY *get_cached_key(key_t *key)
+{
+	key_cache_t *entry;
+	unsigned int err_code;
+	EVP_PKEY *k;
+
+	for (entry = key_cache; entry != NULL; entry = entry->next) {
+		if (strcmp(entry->fn, key->fn) == 0) {
+			return entry->key;
+		}
+	}
+
+	CHECK_NULL(k, EVP_PKEY_new());
+	key->key = k;
+	if (!key_load(key, &err_code)) {
+		ERROR("Error loading '%s'\n", key->fn);
+		exit(1);
+	}
+
+	CHECK_NULL(entry, malloc(sizeof(*entry)));
+	entry->fn = strdup(key->fn);
+	entry->key = key->key;
+	entry->next = key_cache;
+	key_cache = entry;
+
+	return entry->key;
+}
+
+/*
+ * Read the configurations listed in the manifest, one per line as command line
+ * options, and check their options. The keys given by every configuration are
+ * recorded in 'batch_keys'.
+ */
+static void parse_manifest(const struct option *cmd_opt)
+{
+	char line[MANIFEST_LINE_LEN];
+	char *argv[MANIFEST_MAX_ARGS + 1];
+	unsigned int key_count[num_keys];
+	unsigned char key_seen[num_keys];
+	batch_cfg_t *cfg, **last = &batch_cfgs;
+	int argc, c, opt_idx, i, num_cfgs = 0, lineno = 0;
+	key_t *key;
+	FILE *fp;
+	char *p;
+
+	fp = fopen(manifest_fn, "r");
+	if (fp == NULL) {
+		ERROR("Cannot open manifest %s\n", manifest_fn);
+		exit(1);
+	}
+
+	memset(key_count, 0, sizeof(key_count));
+
+	while (fgets(line, sizeof(line), fp) != NULL) {
+		lineno++;
+		if (strchr(line, '\n') == NULL && !feof(fp)) {
+			ERROR("%s:%d: line too long\n", manifest_fn, lineno);
+			exit(1);
+		}
+
+		/* Split the line into arguments, skipping comments */
+		argc = 0;
+		argv[argc++] = (char *)manifest_fn;
+		for (p = strtok(line, " \t\r\n"); p != NULL && *p != '#';
+		     p = strtok(NULL, " \t\r\n")) {
+			if (argc == MANIFEST_MAX_ARGS) {
+				ERROR("%s:%d: too many options\n",
+				      manifest_fn, lineno);
+				exit(1);
+			}
+			argv[argc++] = p;
+		}
+		argv[argc] = NULL;
+		if (argc == 1) {
+			continue;
+		}
+
+		CHECK_NULL(cfg, malloc(sizeof(*cfg)));
+		CHECK_NULL(cfg->argv, calloc(argc + 1, sizeof(char *)));
+		cfg->lineno = lineno;
+		cfg->argc = argc;
+		cfg->argv[0] = argv[0];
+		for (i = 1 ; i < argc ; i++) {
+			CHECK_NULL(cfg->argv[i], strdup(argv[i]));
+		}
+		cfg->next = NULL;
+		*last = cfg;
+		last = &cfg->next;
+
+		/* Check the options and note the keys they give */
+		memset(key_seen, 0, sizeof(key_seen));
+		optind = 1;
+		while ((c = getopt_long(cfg->argc, cfg->argv, "", cmd_opt,
+					&opt_idx)) != -1) {
+			if (c != CMD_OPT_EXT && c != CMD_OPT_KEY &&
+			    c != CMD_OPT_CERT) {
+				ERROR("%s:%d: invalid option in manifest\n",
+				      manifest_fn, lineno);
+				exit(1);
+			}
+			if (c == CMD_OPT_KEY) {
+				key = key_get_by_opt(cmd_opt_get_name(opt_idx));
+				key_seen[key - keys] = 1;
+			}
+		}
+		if (optind != cfg->argc) {
+			ERROR("%s:%d: unexpected argument '%s'\n",
+			      manifest_fn, lineno, cfg->argv[optind]);
+			exit(1);
+		}
+		for (i = 0 ; i < num_keys ; i++) {
+			key_count[i] += key_seen[i];
+		}
+		num_cfgs++;
+	}
+	fclose(fp);
+
+	CHECK_NULL(batch_keys, calloc(num_keys, 1));
+	for (i = 0 ; i < num_keys ; i++) {
+		batch_keys[i] = (num_cfgs > 0) &&
+				(key_count[i] == (unsigned int)num_cfgs);
+	}
+}
+
+/*
+ * Release the certificates and the option values of the current configuration,
+ * and go back to the default keys
+ */
+static void reset_batch_cfg(EVP_PKEY **default_keys, char **default_key_fn)
+{
+	int i;
+
+	for (i = 0 ; i < num_certs ; i++) {
+		X509_free(certs[i].x);
+		certs[i].x = NULL;
+		free((void *)certs[i].fn);
+		certs[i].fn = NULL;
+	}
+	for (i = 0 ; i < num_extensions ; i++) {
+		free((void *)extensions[i].arg);
+		extensions[i].arg = NULL;
+	}
+	for (i = 0 ; i < num_keys ; i++) {
+		/* The key cache keeps its own copy of the filename */
+		if (keys[i].fn != default_key_fn[i]) {
+			free((void *)keys[i].fn);
+		}
+		keys[i].key = default_keys[i];
+		keys[i].fn = default_key_fn[i];
+	}
+}
+
+/*
+ * Create the certificates of every configuration listed in the manifest
+ */
+static void run_batch(const struct option *cmd_opt)
+{
+	EVP_PKEY *default_keys[num_keys];
+	char *default_key_fn[num_keys];
+	int c, opt_idx, i, num_cfgs = 0;
+	double t = get_time();
+	batch_cfg_t *cfg;
+
+	for (i = 0 ; i < num_keys ; i++) {
+		default_keys[i] = keys[i].key;
+		default_key_fn[i] = keys[i].fn;
+	}
+
+	for (cfg = batch_cfgs; cfg != NULL; cfg = cfg->next) {
+		reset_batch_cfg(default_keys, default_key_fn);
+
+		/* The options have been checked by parse_manifest() */
+		optind = 1;
+		while ((c = getopt_long(cfg->argc, cfg->argv, "", cmd_opt,
+					&opt_idx)) != -1) {
+			set_cot_opt(c, opt_idx, optarg);
+		}
+
+		/* Use the keys given in the manifest */
+		for (i = 0 ; i < num_keys ; i++) {
+			if (keys[i].fn != default_key_fn[i]) {
+				keys[i].key = get_cached_key(&keys[i]);
+			}
+		}
+
+		check_cmd_params();
+		create_certs();
+		num_cfgs++;
+	}
+
+	reset_batch_cfg(default_keys, default_key_fn);
+
+	if (print_stats) {
+		NOTICE("%d configurations processed in %.3fs\n", num_cfgs,
+		       get_time() - t);
+	}
+}
+
+int main(int argc, char *argv[])
+{
+	int i;
 	int c, opt_idx = 0;
 	const struct option *cmd_opt;
-	const char *cur_opt;
-	unsigned int err_code;
-	unsigned char md[SHA512_DIGEST_LENGTH];
-	unsigned int  md_len;
-	const EVP_MD *md_info;
+	double t_start = get_time(), t;
 
 	NOTICE("CoT Generation Tool: %s\n", build_msg);
 	NOTICE("Target platform: %s\n", platform_msg);
@@ -315,7 +929,7 @@ int main(int argc, char *argv[])
 
 	while (1) {
 		/* getopt_long stores the option index here. */
-		c = getopt_long(argc, argv, "a:hknps:", cmd_opt, &opt_idx);
+		c = getopt_long(argc, argv, "a:b:hj:knps:t", cmd_opt, &opt_idx);
 
 		/* Detect the end of the options. */
 		if (c == -1) {
@@ -330,9 +944,19 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
+		case 'b':
+			manifest_fn = optarg;
+			break;
 		case 'h':
 			print_help(argv[0], cmd_opt);
 			exit(0);
+		case 'j':
+			num_jobs = atoi(optarg);
+			if (num_jobs < 1) {
+				ERROR("Invalid number of jobs '%s'\n", optarg);
+				exit(1);
+			}
+			break;
 		case 'k':
 			save_keys = 1;
 			break;
@@ -349,20 +973,13 @@ int main(int argc, char *argv[])
 				exit(1);
 			}
 			break;
-		case CMD_OPT_EXT:
-			cur_opt = cmd_opt_get_name(opt_idx);
-			ext = ext_get_by_opt(cur_opt);
-			ext->arg = strdup(optarg);
+		case 't':
+			print_stats = 1;
 			break;
+		case CMD_OPT_EXT:
 		case CMD_OPT_KEY:
-			cur_opt = cmd_opt_get_name(opt_idx);
-			key = key_get_by_opt(cur_opt);
-			key->fn = strdup(optarg);
-			break;
 		case CMD_OPT_CERT:
-			cur_opt = cmd_opt_get_name(opt_idx);
-			cert = cert_get_by_opt(cur_opt);
-			cert->fn = strdup(optarg);
+			set_cot_opt(c, opt_idx, optarg);
 			break;
 		case '?':
 		default:
@@ -371,8 +988,23 @@ int main(int argc, char *argv[])
 		}
 	}
 
+	if (num_jobs == 0) {
+		num_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+		if (num_jobs < 1) {
+			num_jobs = 1;
+		}
+	}
+
 	/* Check command line arguments */
-	check_cmd_params();
+	if (manifest_fn == NULL) {
+		check_cmd_params();
+	} else if (save_keys && !new_keys) {
+		ERROR("Only new keys can be saved to disk\n");
+		exit(1);
+	} else {
+		/* Find out which keys the manifest gives before loading any */
+		parse_manifest(cmd_opt);
+	}
 
 	/* Indicate SHA as image hash algorithm in the certificate
 	 * extension */
@@ -393,137 +1025,18 @@ int main(int argc, char *argv[])
 			ERROR("Failed to allocate key container\n");
 			exit(1);
 		}
-
-		/* First try to load the key from disk */
-		if (key_load(&keys[i], &err_code)) {
-			/* Key loaded successfully */
-			continue;
-		}
-
-		/* Key not loaded. Check the error code */
-		if (err_code == KEY_ERR_LOAD) {
-			/* File exists, but it does not contain a valid private
-			 * key. Abort. */
-			ERROR("Error loading '%s'\n", keys[i].fn);
-			exit(1);
-		}
-
-		/* File does not exist, could not be opened or no filename was
-		 * given */
-		if (new_keys) {
-			/* Try to create a new key */
-			NOTICE("Creating new key for '%s'\n", keys[i].desc);
-			if (!key_create(&keys[i], key_alg)) {
-				ERROR("Error creating key '%s'\n", keys[i].desc);
-				exit(1);
-			}
-		} else {
-			if (err_code == KEY_ERR_OPEN) {
-				ERROR("Error opening '%s'\n", keys[i].fn);
-			} else {
-				ERROR("Key '%s' not specified\n", keys[i].desc);
-			}
-			exit(1);
-		}
 	}
-
-	/* Create the certificates */
-	for (i = 0 ; i < num_certs ; i++) {
-
-		cert = &certs[i];
-
-		/* Create a new stack of extensions. This stack will be used
-		 * to create the certificate */
-		CHECK_NULL(sk, sk_X509_EXTENSION_new_null());
-
-		for (j = 0 ; j < cert->num_ext ; j++) {
-
-			ext = &extensions[cert->ext[j]];
-
-			/* Get OpenSSL internal ID for this extension */
-			CHECK_OID(ext_nid, ext->oid);
-
-			/*
-			 * Three types of extensions are currently supported:
-			 *     - EXT_TYPE_NVCOUNTER
-			 *     - EXT_TYPE_HASH
-			 *     - EXT_TYPE_PKEY
-			 */
-			switch (ext->type) {
-			case EXT_TYPE_NVCOUNTER:
-				if (ext->arg) {
-					nvctr = atoi(ext->arg);
-					CHECK_NULL(cert_ext, ext_new_nvcounter(ext_nid,
-						EXT_CRIT, nvctr));
-				}
-				break;
-			case EXT_TYPE_HASH:
-				if (ext->arg == NULL) {
-					if (ext->optional) {
-						/* Include a hash filled with zeros */
-						memset(md, 0x0, SHA512_DIGEST_LENGTH);
-					} else {
-						/* Do not include this hash in the certificate */
-						break;
-					}
-				} else {
-					/* Calculate the hash of the file */
-					if (!sha_file(hash_alg, ext->arg, md)) {
-						ERROR("Cannot calculate hash of %s\n",
-							ext->arg);
-						exit(1);
-					}
-				}
-				CHECK_NULL(cert_ext, ext_new_hash(ext_nid,
-						EXT_CRIT, md_info, md,
-						md_len));
-				break;
-			case EXT_TYPE_PKEY:
-				CHECK_NULL(cert_ext, ext_new_key(ext_nid,
-					EXT_CRIT, keys[ext->attr.key].key));
-				break;
-			default:
-				ERROR("Unknown extension type '%d' in %s\n",
-						ext->type, cert->cn);
-				exit(1);
-			}
-
-			/* Push the extension into the stack */
-			sk_X509_EXTENSION_push(sk, cert_ext);
-		}
-
-		/* Create certificate. Signed with corresponding key */
-		if (cert->fn && !cert_new(key_alg, hash_alg, cert, VAL_DAYS, 0, sk)) {
-			ERROR("Cannot create %s\n", cert->cn);
-			exit(1);
-		}
-
-		sk_X509_EXTENSION_free(sk);
+	t = get_time();
+	run_jobs(num_keys, job_always_ready, load_key);
+	if (print_stats) {
+		NOTICE("Keys loaded in %.3fs\n", get_time() - t);
 	}
 
-
-	/* Print the certificates */
-	if (print_cert) {
-		for (i = 0 ; i < num_certs ; i++) {
-			if (!certs[i].x) {
-				continue;
-			}
-			printf("\n\n=====================================\n\n");
-			X509_print_fp(stdout, certs[i].x);
-		}
-	}
-
-	/* Save created certificates to files */
-	for (i = 0 ; i < num_certs ; i++) {
-		if (certs[i].x && certs[i].fn) {
-			file = fopen(certs[i].fn, "w");
-			if (file != NULL) {
-				i2d_X509_fp(file, certs[i].x);
-				fclose(file);
-			} else {
-				ERROR("Cannot create file %s\n", certs[i].fn);
-			}
-		}
+	/* Create the certificates */
+	if (manifest_fn == NULL) {
+		create_certs();
+	} else {
+		run_batch(cmd_opt);
 	}
 
 	/* Save keys */
@@ -540,5 +1053,10 @@ int main(int argc, char *argv[])
 #endif
 	CRYPTO_cleanup_all_ex_data();
 
+	if (print_stats) {
+		NOTICE("Total time %.3fs using %d jobs\n", get_time() - t_start,
+		       num_jobs);
+	}
+
 	return 0;
 }
@@ -0,0 +1,87 @@
+#!/bin/sh
+#
+# This script benchmarks fiptool on synthetic FIP files with large payloads.
+#
+# SPDX-License-Identifier: BSD-3-Clause
+#
+
+usage() {
+    cat << EOF_USAGE
+This tool benchmarks fiptool on synthetic large FIP files.
+
+Usage:
+	fip_bench.sh [options]
+
+Options:
+	-h,--help: Print this help message and exit
+	-f,--fiptool PATH: fiptool binary to benchmark (default: ./fiptool)
+	-s,--size MIB: Size of each synthetic payload in MiB (default: 64)
+	-j,--jobs N: Number of hashing threads passed to fiptool
+	-w,--workdir DIR: Directory used for the synthetic files (default: mktemp)
+EOF_USAGE
+}
+
+FIPTOOL=./fiptool
+SIZE=64
+JOBS=
+WORKDIR=
+
+while [ $# -gt 0 ]; do
+    case "$1" in
+    -h|--help)
+        usage
+        exit 0
+        ;;
+    -f|--fiptool)
+        FIPTOOL="$2"
+        shift
+        ;;
+    -s|--size)
+        SIZE="$2"
+        shift
+        ;;
+    -j|--jobs)
+        JOBS="--jobs $2"
+        shift
+        ;;
+    -w|--workdir)
+        WORKDIR="$2"
+        shift
+        ;;
+    *)
+        usage
+        exit 1
+        ;;
+    esac
+    shift
+done
+
+if [ ! -x "$FIPTOOL" ]; then
+    echo "fiptool not found at $FIPTOOL" >&2
+    exit 1
+fi
+
+if [ -z "$WORKDIR" ]; then
+    WORKDIR=$(mktemp -d)
+    trap 'rm -rf "$WORKDIR"' EXIT
+fi
+
+# Generate one payload per image type packed into the synthetic FIP.
+IMAGES="tb-fw soc-fw tos-fw tos-fw-extra1 tos-fw-extra2 nt-fw scp-fw"
+ARGS=
+for img in $IMAGES; do
+    dd if=/dev/urandom of="$WORKDIR/$img.bin" bs=1M count="$SIZE" 2>/dev/null
+    ARGS="$ARGS --$img $WORKDIR/$img.bin"
+done
+dd if=/dev/urandom of="$WORKDIR/nt-fw-small.bin" bs=1K count=4 2>/dev/null
+
+run() {
+    echo "== fiptool $*"
+    "$FIPTOOL" --stats $JOBS "$@" > /dev/null
+}
+
+run create --align 4096 $ARGS "$WORKDIR/fip.bin"
+run --verbose info "$WORKDIR/fip.bin"
+run update --nt-fw "$WORKDIR/nt-fw-small.bin" "$WORKDIR/fip.bin"
+mkdir -p "$WORKDIR/unpack"
+run unpack --force --out "$WORKDIR/unpack" "$WORKDIR/fip.bin"
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -22,6 +22,7 @@
 #define OPT_TOC_ENTRY 0
 #define OPT_PLAT_TOC_FLAGS 1
 #define OPT_ALIGN 2
+#define OPT_IN_PLACE 3
 
 static int info_cmd(int argc, char *argv[]);
 static void info_usage(void);
@@ -53,6 +54,23 @@ static image_desc_t *image_desc_head;
 static size_t nr_image_descs;
 static const uuid_t uuid_null;
 static int verbose;
+static int print_stats;
+static long nr_jobs;
+/* The FIP parsed by parse_fip(), image buffers point into it. */
+static file_map_t fip_map;
+#ifndef _MSC_VER
+static char fip_tmpfile[PATH_MAX];
+#endif
+
+/* Timing and I/O statistics reported with --stats. */
+static struct {
+	double   t_start;
+	double   t_read;
+	double   t_hash;
+	double   t_write;
+	uint64_t bytes_in;
+	uint64_t bytes_out;
+} stats;
 
 static void vlog(int prio, const char *msg, va_list ap)
 {
@@ -132,6 +150,90 @@ static void xfwrite(void *buf, size_t size, FILE *fp, const char *filename)
 {
 	if (fwrite(buf, 1, size, fp) != size)
 		log_errx("Failed to write %s", filename);
+	stats.bytes_out += size;
+}
+
+static void xfpad(uint64_t size, FILE *fp, const char *filename)
+{
+	static char zero[4096];
+
+	while (size > 0) {
+		size_t len = size < sizeof(zero) ? size : sizeof(zero);
+
+		xfwrite(zero, len, fp, filename);
+		size -= len;
+	}
+}
+
+static double get_time(void)
+{
+#ifndef _MSC_VER
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+#else
+	return (double)clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+/*
+ * Map a whole file read-only into memory so that payloads can be hashed and
+ * written out without being copied. Hosts without mmap() read the file into
+ * a heap buffer instead.
+ */
+static void map_file(const char *filename, file_map_t *map)
+{
+	struct BLD_PLAT_STAT st;
+	double t = get_time();
+	FILE *fp;
+
+	fp = fopen(filename, "rb");
+	if (fp == NULL)
+		log_err("fopen %s", filename);
+
+	if (fstat(fileno(fp), &st) == -1)
+		log_err("fstat %s", filename);
+
+	map->addr = NULL;
+	map->size = st.st_size;
+	if (map->size != 0) {
+#ifndef _MSC_VER
+		map->addr = mmap(NULL, map->size, PROT_READ, MAP_PRIVATE,
+		    fileno(fp), 0);
+		if (map->addr == MAP_FAILED)
+			log_err("mmap %s", filename);
+		posix_madvise(map->addr, map->size, POSIX_MADV_SEQUENTIAL);
+#else
+		map->addr = xmalloc(map->size,
+		    "failed to load file into memory");
+		if (fread(map->addr, 1, map->size, fp) != map->size)
+			log_errx("Failed to read %s", filename);
+#endif
+	}
+	fclose(fp);
+
+	stats.bytes_in += map->size;
+	stats.t_read += get_time() - t;
+}
+
+static void unmap_file(file_map_t *map)
+{
+	if (map->addr != NULL) {
+#ifndef _MSC_VER
+		munmap(map->addr, map->size);
+#else
+		free(map->addr);
+#endif
+	}
+	map->addr = NULL;
+	map->size = 0;
+}
+
+static void free_image(image_t *image)
+{
+	unmap_file(&image->map);
+	free(image);
 }
 
 static image_desc_t *new_image_desc(const uuid_t *uuid,
@@ -169,10 +271,8 @@ static void free_image_desc(image_desc_t *desc)
 	free(desc->name);
 	free(desc->cmdline_name);
 	free(desc->action_arg);
-	if (desc->image) {
-		free(desc->image->buffer);
-		free(desc->image);
-	}
+	if (desc->image)
+		free_image(desc->image);
 	free(desc);
 }
 
@@ -199,6 +299,7 @@ static void free_image_descs(void)
 		nr_image_descs--;
 	}
 	assert(nr_image_descs == 0);
+	unmap_file(&fip_map);
 }
 
 static void fill_image_descs(void)
@@ -280,27 +381,17 @@ static void uuid_from_str(uuid_t *u, const char *s)
 
 static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 {
-	struct BLD_PLAT_STAT st;
-	FILE *fp;
 	char *buf, *bufend;
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	int terminated = 0;
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_err("fstat %s", filename);
+	assert(fip_map.addr == NULL);
+	map_file(filename, &fip_map);
+	buf = fip_map.addr;
+	bufend = buf + fip_map.size;
 
-	buf = xmalloc(st.st_size, "failed to load file into memory");
-	if (fread(buf, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	bufend = buf + st.st_size;
-	fclose(fp);
-
-	if (st.st_size < sizeof(fip_toc_header_t))
+	if (fip_map.size < sizeof(fip_toc_header_t))
 		log_errx("FIP %s is truncated", filename);
 
 	toc_header = (fip_toc_header_t *)buf;
@@ -328,19 +419,17 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 		 * Build a new image out of the ToC entry and add it to the
 		 * table of images.
 		 */
-		image = xzalloc(sizeof(*image),
-		    "failed to allocate memory for image");
-		image->toc_e = *toc_entry;
-		image->buffer = xmalloc(toc_entry->size,
-		    "failed to allocate image buffer, is FIP file corrupted?");
-		/* Overflow checks before memory copy. */
+		/* Overflow checks before referencing the payload. */
 		if (toc_entry->size > (uint64_t)-1 - toc_entry->offset_address)
 			log_errx("FIP %s is corrupted", filename);
-		if (toc_entry->size + toc_entry->offset_address > st.st_size)
+		if (toc_entry->size + toc_entry->offset_address > fip_map.size)
 			log_errx("FIP %s is corrupted", filename);
 
-		memcpy(image->buffer, buf + toc_entry->offset_address,
-		    toc_entry->size);
+		/* The payload is used in place from the mapped FIP. */
+		image = xzalloc(sizeof(*image),
+		    "failed to allocate memory for image");
+		image->toc_e = *toc_entry;
+		image->buffer = buf + toc_entry->offset_address;
 
 		/* If this is an unknown image, create a descriptor for it. */
 		desc = lookup_image_desc_from_uuid(&toc_entry->uuid);
@@ -366,46 +455,37 @@ static int parse_fip(const char *filename, fip_toc_header_t *toc_header_out)
 	if (terminated == 0)
 		log_errx("FIP %s does not have a ToC terminator entry",
 		    filename);
-	free(buf);
 	return 0;
 }
 
 static image_t *read_image_from_file(const uuid_t *uuid, const char *filename)
 {
-	struct BLD_PLAT_STAT st;
 	image_t *image;
-	FILE *fp;
 
 	assert(uuid != NULL);
 	assert(filename != NULL);
 
-	fp = fopen(filename, "rb");
-	if (fp == NULL)
-		log_err("fopen %s", filename);
-
-	if (fstat(fileno(fp), &st) == -1)
-		log_errx("fstat %s", filename);
-
 	image = xzalloc(sizeof(*image), "failed to allocate memory for image");
 	image->toc_e.uuid = *uuid;
-	image->buffer = xmalloc(st.st_size, "failed to allocate image buffer");
-	if (fread(image->buffer, 1, st.st_size, fp) != st.st_size)
-		log_errx("Failed to read %s", filename);
-	image->toc_e.size = st.st_size;
+	map_file(filename, &image->map);
+	image->buffer = image->map.addr;
+	image->toc_e.size = image->map.size;
 
-	fclose(fp);
 	return image;
 }
 
 static int write_image_to_file(const image_t *image, const char *filename)
 {
+	double t = get_time();
 	FILE *fp;
 
 	fp = fopen(filename, "wb");
 	if (fp == NULL)
 		log_err("fopen");
 	xfwrite(image->buffer, image->toc_e.size, fp, filename);
-	fclose(fp);
+	if (fclose(fp) != 0)
+		log_err("fclose %s", filename);
+	stats.t_write += get_time() - t;
 	return 0;
 }
 
@@ -442,10 +522,76 @@ static void md_print(const unsigned char *md, size_t len)
 		printf("%02x", md[i]);
 }
 
+#ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
+typedef struct hash_job {
+	const image_t *image;
+	unsigned char  md[SHA256_DIGEST_LENGTH];
+} hash_job_t;
+
+/* Work queue shared by the hash worker threads. */
+static struct {
+	pthread_mutex_t lock;
+	hash_job_t     *jobs;
+	size_t          nr_jobs;
+	size_t          next;
+} hash_queue = { .lock = PTHREAD_MUTEX_INITIALIZER };
+
+static void *hash_worker(void *arg)
+{
+	hash_job_t *job;
+
+	while (1) {
+		pthread_mutex_lock(&hash_queue.lock);
+		job = NULL;
+		if (hash_queue.next < hash_queue.nr_jobs)
+			job = &hash_queue.jobs[hash_queue.next++];
+		pthread_mutex_unlock(&hash_queue.lock);
+
+		if (job == NULL)
+			break;
+		SHA256(job->image->buffer, job->image->toc_e.size, job->md);
+	}
+	return NULL;
+}
+
+/* Compute the SHA-256 of each job's image on a pool of worker threads. */
+static void hash_images(hash_job_t *jobs, size_t n)
+{
+	pthread_t *threads;
+	size_t i, nr_threads;
+	double t = get_time();
+
+	hash_queue.jobs = jobs;
+	hash_queue.nr_jobs = n;
+	hash_queue.next = 0;
+
+	nr_threads = (size_t)nr_jobs < n ? (size_t)nr_jobs : n;
+	if (nr_threads <= 1) {
+		hash_worker(NULL);
+	} else {
+		threads = xmalloc(nr_threads * sizeof(*threads),
+		    "failed to allocate memory for hash workers");
+		for (i = 0; i < nr_threads; i++)
+			if (pthread_create(&threads[i], NULL, hash_worker,
+			    NULL) != 0)
+				log_errx("Failed to create hash worker");
+		for (i = 0; i < nr_threads; i++)
+			pthread_join(threads[i], NULL);
+		free(threads);
+	}
+
+	stats.t_hash += get_time() - t;
+}
+#endif
+
 static int info_cmd(int argc, char *argv[])
 {
 	image_desc_t *desc;
 	fip_toc_header_t toc_header;
+#ifndef _MSC_VER
+	hash_job_t *jobs = NULL, *job = NULL;
+	size_t nr_images = 0;
+#endif
 
 	if (argc != 2)
 		info_usage();
@@ -462,6 +608,23 @@ static int info_cmd(int argc, char *argv[])
 		    (unsigned long long)toc_header.flags);
 	}
 
+#ifndef _MSC_VER
+	/* Hash all the payloads up front, in parallel. */
+	if (verbose) {
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			if (desc->image != NULL)
+				nr_images++;
+		jobs = xzalloc((nr_images + 1) * sizeof(*jobs),
+		    "failed to allocate memory for hash jobs");
+		job = jobs;
+		for (desc = image_desc_head; desc != NULL; desc = desc->next)
+			if (desc->image != NULL)
+				(job++)->image = desc->image;
+		hash_images(jobs, nr_images);
+		job = jobs;
+	}
+#endif
+
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
@@ -474,16 +637,17 @@ static int info_cmd(int argc, char *argv[])
 		       desc->cmdline_name);
 #ifndef _MSC_VER	/* We don't have SHA256 for Visual Studio. */
 		if (verbose) {
-			unsigned char md[SHA256_DIGEST_LENGTH];
-
-			SHA256(image->buffer, image->toc_e.size, md);
 			printf(", sha256=");
-			md_print(md, sizeof(md));
+			md_print(job->md, sizeof(job->md));
+			job++;
 		}
 #endif
 		putchar('\n');
 	}
 
+#ifndef _MSC_VER
+	free(jobs);
+#endif
 	return 0;
 }
 
@@ -493,6 +657,15 @@ static void info_usage(void)
 	exit(1);
 }
 
+#ifndef _MSC_VER
+/* Remove a partially written FIP if the tool exits before renaming it. */
+static void remove_fip_tmpfile(void)
+{
+	if (fip_tmpfile[0] != '\0')
+		unlink(fip_tmpfile);
+}
+#endif
+
 static int pack_images(const char *filename, uint64_t toc_flags, unsigned long align)
 {
 	FILE *fp;
@@ -500,8 +673,10 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	fip_toc_header_t *toc_header;
 	fip_toc_entry_t *toc_entry;
 	char *buf;
-	uint64_t entry_offset, buf_size, payload_size = 0, pad_size;
+	const char *tmpfile;
+	uint64_t entry_offset, buf_size, payload_size = 0, file_offset;
 	size_t nr_images = 0;
+	double t = get_time();
 
 	for (desc = image_desc_head; desc != NULL; desc = desc->next)
 		if (desc->image != NULL)
@@ -542,10 +717,34 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	memset(toc_entry, 0, sizeof(*toc_entry));
 	toc_entry->offset_address = (entry_offset + align - 1) & ~(align - 1);
 
+#ifndef _MSC_VER
+	/*
+	 * The payloads may be mapped from the FIP that is being overwritten, so
+	 * generate the new FIP in a temporary file and move it into place once
+	 * it is complete. The temporary file is removed if any write fails.
+	 */
+	snprintf(fip_tmpfile, sizeof(fip_tmpfile), "%s.tmp", filename);
+	tmpfile = fip_tmpfile;
+	atexit(remove_fip_tmpfile);
+#else
+	tmpfile = filename;
+#endif
+
 	/* Generate the FIP file. */
-	fp = fopen(filename, "wb");
+	fp = fopen(tmpfile, "wb");
 	if (fp == NULL)
-		log_err("fopen %s", filename);
+		log_err("fopen %s", tmpfile);
+
+#ifndef _MSC_VER
+	/* Keep the permissions of the FIP that is being replaced. */
+	{
+		struct stat st;
+
+		if (stat(filename, &st) == 0 &&
+		    fchmod(fileno(fp), st.st_mode & 07777) == -1)
+			log_err("fchmod %s", tmpfile);
+	}
+#endif
 
 	if (verbose)
 		log_dbgx("Metadata size: %zu bytes", buf_size);
@@ -555,28 +754,217 @@ static int pack_images(const char *filename, uint64_t toc_flags, unsigned long a
 	if (verbose)
 		log_dbgx("Payload size: %zu bytes", payload_size);
 
+	/* Stream the payloads and alignment padding out in file order. */
+	file_offset = buf_size;
 	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
 		image_t *image = desc->image;
 
 		if (image == NULL)
 			continue;
-		if (fseek(fp, image->toc_e.offset_address, SEEK_SET))
-			log_errx("Failed to set file position");
-
+		xfpad(image->toc_e.offset_address - file_offset, fp, filename);
 		xfwrite(image->buffer, image->toc_e.size, fp, filename);
+		file_offset = image->toc_e.offset_address + image->toc_e.size;
 	}
 
-	if (fseek(fp, entry_offset, SEEK_SET))
-		log_errx("Failed to set file position");
-
-	pad_size = toc_entry->offset_address - entry_offset;
-	while (pad_size--)
-		fputc(0x0, fp);
+	xfpad(toc_entry->offset_address - file_offset, fp, filename);
 
 	free(buf);
-	fclose(fp);
+	if (fclose(fp) != 0)
+		log_err("fclose %s", tmpfile);
+#ifndef _MSC_VER
+	if (rename(tmpfile, filename) == -1)
+		log_err("rename %s", filename);
+	fip_tmpfile[0] = '\0';
+#endif
+	stats.t_write += get_time() - t;
+	return 0;
+}
+
+#ifndef _MSC_VER
+static void xpread(int fd, void *buf, size_t size, uint64_t offset,
+    const char *filename)
+{
+	if (pread(fd, buf, size, offset) != (ssize_t)size)
+		log_errx("Failed to read %s", filename);
+	stats.bytes_in += size;
+}
+
+static void xpwrite(int fd, const void *buf, size_t size, uint64_t offset,
+    const char *filename)
+{
+	if (pwrite(fd, buf, size, offset) != (ssize_t)size)
+		log_errx("Failed to write %s", filename);
+	stats.bytes_out += size;
+}
+
+static void xpwrite_zero(int fd, uint64_t size, uint64_t offset,
+    const char *filename)
+{
+	static char zero[4096];
+
+	while (size > 0) {
+		size_t len = size < sizeof(zero) ? size : sizeof(zero);
+
+		xpwrite(fd, zero, len, offset, filename);
+		offset += len;
+		size -= len;
+	}
+}
+
+/* Move the bytes in [from, end) of a file towards its end by delta bytes. */
+static void shift_file_tail(int fd, uint64_t from, uint64_t end,
+    uint64_t delta, const char *filename)
+{
+	static char buf[1 << 20];
+	uint64_t pos = end;
+
+	/* Copy backwards as the source and destination may overlap. */
+	while (pos > from) {
+		size_t len = pos - from < sizeof(buf) ? pos - from : sizeof(buf);
+
+		pos -= len;
+		xpread(fd, buf, len, pos, filename);
+		xpwrite(fd, buf, len, pos + delta, filename);
+	}
+}
+
+static int cmp_image_offset(const void *a, const void *b)
+{
+	const image_t *ia = *(image_t * const *)a;
+	const image_t *ib = *(image_t * const *)b;
+
+	if (ia->toc_e.offset_address != ib->toc_e.offset_address)
+		return ia->toc_e.offset_address < ib->toc_e.offset_address ?
+		    -1 : 1;
+	/* Empty images share their offset with the next image. */
+	if (ia->toc_e.size != ib->toc_e.size)
+		return ia->toc_e.size < ib->toc_e.size ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Replace images of the FIP parsed by parse_fip() without rewriting the
+ * whole file. A replacement that fits in the slot of the old image, including
+ * its alignment padding, is written in place. Otherwise the rest of the file
+ * is shifted by a multiple of the alignment to make room for it. Only the
+ * ToC and the bytes of the changed images and the shifted tail are written.
+ *
+ * Returns -1 if the FIP cannot be updated in place, in which case it has not
+ * been modified.
+ */
+static int update_fip_in_place(const char *filename, uint64_t toc_flags,
+    unsigned long align)
+{
+	image_desc_t *desc;
+	image_t **images;
+	fip_toc_header_t *toc_header;
+	fip_toc_entry_t *toc_entry;
+	uint64_t file_end, slot_end, delta;
+	size_t nr_images = 0, toc_size, i, j;
+	double t;
+	int fd;
+
+	for (desc = image_desc_head; desc != NULL; desc = desc->next) {
+		/* A new image needs a new ToC entry, which moves every image. */
+		if (desc->action == DO_PACK && desc->image == NULL)
+			return -1;
+		if (desc->image != NULL)
+			nr_images++;
+	}
+
+	/* Keep a copy of the on-disk ToC, including the terminator entry. */
+	toc_size = sizeof(fip_toc_header_t) +
+	    sizeof(fip_toc_entry_t) * (nr_images + 1);
+	assert(fip_map.size >= toc_size);
+	toc_header = xmalloc(toc_size, "failed to allocate memory for ToC");
+	memcpy(toc_header, fip_map.addr, toc_size);
+	toc_header->flags = toc_flags;
+	toc_entry = (fip_toc_entry_t *)(toc_header + 1);
+
+	/* Work on the images in file order. */
+	images = xmalloc((nr_images + 1) * sizeof(*images),
+	    "failed to allocate memory for image table");
+	i = 0;
+	for (desc = image_desc_head; desc != NULL; desc = desc->next)
+		if (desc->image != NULL)
+			images[i++] = desc->image;
+	qsort(images, nr_images, sizeof(*images), cmp_image_offset);
+
+	fd = open(filename, O_RDWR);
+	if (fd == -1)
+		log_err("open %s", filename);
+	t = get_time();
+	file_end = fip_map.size;
+
+	/*
+	 * Go from the end of the file backwards so that a shifted tail never
+	 * contains an image that is replaced afterwards.
+	 */
+	for (i = nr_images; i-- > 0; ) {
+		image_t *old = images[i], *image;
+		uint64_t offset = old->toc_e.offset_address;
+
+		desc = lookup_image_desc_from_uuid(&old->toc_e.uuid);
+		assert(desc != NULL);
+		if (desc->action != DO_PACK)
+			continue;
+
+		if (i + 1 < nr_images)
+			slot_end = images[i + 1]->toc_e.offset_address;
+		else
+			slot_end = toc_entry[nr_images].offset_address;
+		if (slot_end < offset + old->toc_e.size)
+			slot_end = offset + old->toc_e.size;
+
+		image = read_image_from_file(&desc->uuid, desc->action_arg);
+		image->toc_e.offset_address = offset;
+
+		if (image->toc_e.size > slot_end - offset) {
+			delta = offset + image->toc_e.size - slot_end;
+			delta = (delta + align - 1) & ~((uint64_t)align - 1);
+			if (verbose)
+				log_dbgx("Shifting the images after %s by %llu bytes",
+				    desc->cmdline_name,
+				    (unsigned long long)delta);
+			shift_file_tail(fd, slot_end, file_end, delta,
+			    filename);
+			for (j = i + 1; j < nr_images; j++)
+				images[j]->toc_e.offset_address += delta;
+			toc_entry[nr_images].offset_address += delta;
+			slot_end += delta;
+			file_end += delta;
+		} else if (verbose) {
+			log_dbgx("Replacing %s with %s in place",
+			    desc->cmdline_name, desc->action_arg);
+		}
+
+		xpwrite(fd, image->buffer, image->toc_e.size, offset, filename);
+		xpwrite_zero(fd, slot_end - offset - image->toc_e.size,
+		    offset + image->toc_e.size, filename);
+
+		free_image(old);
+		desc->image = image;
+		images[i] = image;
+	}
+
+	/* Update the offsets and sizes in the ToC and write it back. */
+	for (i = 0; i < nr_images; i++) {
+		desc = lookup_image_desc_from_uuid(&toc_entry[i].uuid);
+		assert(desc != NULL && desc->image != NULL);
+		toc_entry[i].offset_address = desc->image->toc_e.offset_address;
+		toc_entry[i].size = desc->image->toc_e.size;
+	}
+	xpwrite(fd, toc_header, toc_size, 0, filename);
+
+	if (close(fd) == -1)
+		log_err("close %s", filename);
+	stats.t_write += get_time() - t;
+
+	free(images);
+	free(toc_header);
 	return 0;
 }
+#endif
 
 /*
  * This function is shared between the create and update subcommands.
@@ -604,7 +992,7 @@ static void update_fip(void)
 				    desc->cmdline_name,
 				    desc->action_arg);
 			}
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = image;
 		} else {
 			if (verbose)
@@ -765,6 +1153,8 @@ static int update_cmd(int argc, char *argv[])
 	unsigned long long toc_flags = 0;
 	unsigned long align = 1;
 	int pflag = 0;
+	int iflag = 0;
+	int fip_parsed = 0;
 
 	if (argc < 2)
 		update_usage();
@@ -772,6 +1162,7 @@ static int update_cmd(int argc, char *argv[])
 	opts = fill_common_opts(opts, &nr_opts, required_argument);
 	opts = add_opt(opts, &nr_opts, "align", required_argument, OPT_ALIGN);
 	opts = add_opt(opts, &nr_opts, "blob", required_argument, 'b');
+	opts = add_opt(opts, &nr_opts, "in-place", no_argument, OPT_IN_PLACE);
 	opts = add_opt(opts, &nr_opts, "out", required_argument, 'o');
 	opts = add_opt(opts, &nr_opts, "plat-toc-flags", required_argument,
 	    OPT_PLAT_TOC_FLAGS);
@@ -821,6 +1212,9 @@ static int update_cmd(int argc, char *argv[])
 		case OPT_ALIGN:
 			align = get_image_align(optarg);
 			break;
+		case OPT_IN_PLACE:
+			iflag = 1;
+			break;
 		case 'o':
 			snprintf(outfile, sizeof(outfile), "%s", optarg);
 			break;
@@ -835,16 +1229,32 @@ static int update_cmd(int argc, char *argv[])
 	if (argc == 0)
 		update_usage();
 
+	if (iflag && outfile[0] != '\0')
+		log_errx("--in-place cannot be used with --out");
+
 	if (outfile[0] == '\0')
 		snprintf(outfile, sizeof(outfile), "%s", argv[0]);
 
-	if (access(argv[0], F_OK) == 0)
+	if (access(argv[0], F_OK) == 0) {
 		parse_fip(argv[0], &toc_header);
+		fip_parsed = 1;
+	}
 
 	if (pflag)
 		toc_header.flags &= ~(0xffffULL << 32);
 	toc_flags = (toc_header.flags |= toc_flags);
 
+	if (iflag) {
+#ifndef _MSC_VER
+		if (fip_parsed &&
+		    update_fip_in_place(outfile, toc_flags, align) == 0)
+			return 0;
+#endif
+		if (verbose)
+			log_dbgx("Cannot update %s in place, rewriting it",
+			    outfile);
+	}
+
 	update_fip();
 
 	pack_images(outfile, toc_flags, align);
@@ -860,6 +1270,7 @@ static void update_usage(void)
 	printf("Options:\n");
 	printf("  --align <value>\t\tEach image is aligned to <value> (default: 1).\n");
 	printf("  --blob uuid=...,file=...\tAdd or update an image with the given UUID pointed to by file.\n");
+	printf("  --in-place\t\t\tOnly rewrite the ToC and the bytes of the changed images when possible.\n");
 	printf("  --out FIP_FILENAME\t\tSet an alternative output FIP file.\n");
 	printf("  --plat-toc-flags <value>\t16-bit platform specific flag field occupying bits 32-47 in 64-bit ToC header.\n");
 	printf("\n");
@@ -1098,7 +1509,7 @@ static int remove_cmd(int argc, char *argv[])
 			if (verbose)
 				log_dbgx("Removing %s",
 				    desc->cmdline_name);
-			free(desc->image);
+			free_image(desc->image);
 			desc->image = NULL;
 		} else {
 			log_warnx("%s does not exist in %s",
@@ -1146,6 +1557,16 @@ static void version_usage(void)
 	exit(1);
 }
 
+static void stats_print(void)
+{
+	fprintf(stderr, "STATS: total=%.3fs read=%.3fs hash=%.3fs write=%.3fs\n",
+	    get_time() - stats.t_start, stats.t_read, stats.t_hash,
+	    stats.t_write);
+	fprintf(stderr, "STATS: in=%llu bytes, out=%llu bytes, jobs=%ld\n",
+	    (unsigned long long)stats.bytes_in,
+	    (unsigned long long)stats.bytes_out, nr_jobs);
+}
+
 static int help_cmd(int argc, char *argv[])
 {
 	int i;
@@ -1166,9 +1587,11 @@ static int help_cmd(int argc, char *argv[])
 
 static void usage(void)
 {
-	printf("usage: fiptool [--verbose] <command> [<args>]\n");
+	printf("usage: fiptool [--verbose] [--stats] [--jobs <n>] <command> [<args>]\n");
 	printf("Global options supported:\n");
 	printf("  --verbose\tEnable verbose output for all commands.\n");
+	printf("  --stats\tReport timing and I/O statistics on exit.\n");
+	printf("  --jobs <n>\tNumber of threads used to hash images (default: number of CPUs).\n");
 	printf("\n");
 	printf("Commands supported:\n");
 	printf("  info\t\tList images contained in FIP.\n");
@@ -1184,11 +1607,16 @@ static void usage(void)
 int main(int argc, char *argv[])
 {
 	int i, ret = 0;
+	char *endptr;
+
+	stats.t_start = get_time();
 
 	while (1) {
 		int c, opt_index = 0;
 		static struct option opts[] = {
 			{ "verbose", no_argument, NULL, 'v' },
+			{ "stats", no_argument, NULL, 's' },
+			{ "jobs", required_argument, NULL, 'j' },
 			{ NULL, no_argument, NULL, 0 }
 		};
 
@@ -1196,7 +1624,7 @@ int main(int argc, char *argv[])
 		 * Set POSIX mode so getopt stops at the first non-option
 		 * which is the subcommand.
 		 */
-		c = getopt_long(argc, argv, "+v", opts, &opt_index);
+		c = getopt_long(argc, argv, "+vsj:", opts, &opt_index);
 		if (c == -1)
 			break;
 
@@ -1204,10 +1632,26 @@ int main(int argc, char *argv[])
 		case 'v':
 			verbose = 1;
 			break;
+		case 's':
+			print_stats = 1;
+			break;
+		case 'j':
+			errno = 0;
+			nr_jobs = strtol(optarg, &endptr, 0);
+			if (*endptr != '\0' || nr_jobs < 1 || errno != 0)
+				log_errx("Invalid number of jobs: %s", optarg);
+			break;
 		default:
 			usage();
 		}
 	}
+
+#ifndef _MSC_VER
+	if (nr_jobs == 0)
+		nr_jobs = sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	if (nr_jobs < 1)
+		nr_jobs = 1;
 	argc -= optind;
 	argv += optind;
 	/* Reset optind for subsequent getopt processing. */
@@ -1226,5 +1670,7 @@ int main(int argc, char *argv[])
 	if (i == NELEM(cmds))
 		usage();
 	free_image_descs();
+	if (print_stats)
+		stats_print();
 	return ret;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2017, ARM Limited and Contributors. All rights reserved.
+ * Copyright (c) 2016-2018, ARM Limited and Contributors. All rights reserved.
  *
  * SPDX-License-Identifier: BSD-3-Clause
  */
@@ -40,9 +40,17 @@ typedef struct image_desc {
 	struct image_desc *next;
 } image_desc_t;
 
+/* A read-only view of a whole file, mmap()ed where the host supports it. */
+typedef struct file_map {
+	void                *addr;
+	size_t               size;
+} file_map_t;
+
 typedef struct image {
 	struct fip_toc_entry toc_e;
 	void                *buffer;
+	/* Backing file owned by the image, unused if it lives in a FIP map. */
+	file_map_t           map;
 } image_t;
 
 typedef struct cmd {
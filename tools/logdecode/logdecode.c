@@ -0,0 +1,347 @@
+/*
+ * Copyright (c) 2018, ARM Limited and Contributors. All rights reserved.
+ *
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/*
+ * Decoder of the binary log of BL31 (BINARY_LOG=1). It takes the BL31 ELF file,
+ * which holds the format strings of the messages, and a raw memory dump which
+ * contains the log, and prints the messages of all the CPUs in time order.
+ */
+
+#include <elf.h>
+#include <errno.h>
+#include <getopt.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "binary_log.h"
+
+typedef struct message {
+	unsigned int cpu;
+	const binary_log_record_t *record;
+} message_t;
+
+static const char *level_prefix[] = {
+	[1] = "ERROR:   ",
+	[2] = "NOTICE:  ",
+	[3] = "WARNING: ",
+	[4] = "INFO:    ",
+	[5] = "VERBOSE: ",
+};
+
+static uint8_t *elf;
+static size_t elf_size;
+static const char *fmt_section;
+static size_t fmt_section_size;
+
+static void usage(void)
+{
+	printf("logdecode -e <bl31.elf> -d <dump> [-t]\n\n");
+	printf("  -e  BL31 ELF file the log was produced by\n");
+	printf("  -d  Raw memory dump containing the binary log\n");
+	printf("  -t  Print the timestamp of the messages\n");
+	exit(1);
+}
+
+static uint8_t *read_file(const char *path, size_t *size)
+{
+	uint8_t *buf;
+	FILE *fp;
+	long len;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		fprintf(stderr, "Failed to open %s: %s\n", path,
+			strerror(errno));
+		exit(1);
+	}
+	if ((fseek(fp, 0, SEEK_END) != 0) || ((len = ftell(fp)) < 0) ||
+	    (fseek(fp, 0, SEEK_SET) != 0)) {
+		fprintf(stderr, "Failed to get the size of %s\n", path);
+		exit(1);
+	}
+	buf = malloc(len + 1);
+	if (buf == NULL) {
+		fprintf(stderr, "Failed to allocate %ld bytes\n", len);
+		exit(1);
+	}
+	if (fread(buf, 1, len, fp) != (size_t)len) {
+		fprintf(stderr, "Failed to read %s\n", path);
+		exit(1);
+	}
+	fclose(fp);
+
+	buf[len] = '\0';
+	*size = len;
+	return buf;
+}
+
+static const Elf64_Shdr *elf_section(unsigned int i)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf;
+
+	return (const Elf64_Shdr *)(elf + ehdr->e_shoff +
+				    (i * ehdr->e_shentsize));
+}
+
+/* Locate the format strings in the BL31 ELF file */
+static void elf_init(void)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf;
+	const Elf64_Shdr *shdr, *strtab;
+	unsigned int i;
+
+	if ((elf_size < sizeof(*ehdr)) ||
+	    (memcmp(ehdr->e_ident, ELFMAG, SELFMAG) != 0) ||
+	    (ehdr->e_ident[EI_CLASS] != ELFCLASS64) ||
+	    (ehdr->e_ident[EI_DATA] != ELFDATA2LSB) ||
+	    (ehdr->e_shoff + (ehdr->e_shnum * ehdr->e_shentsize) > elf_size) ||
+	    (ehdr->e_shstrndx >= ehdr->e_shnum)) {
+		fprintf(stderr, "Not a supported ELF file\n");
+		exit(1);
+	}
+
+	strtab = elf_section(ehdr->e_shstrndx);
+	for (i = 0; i < ehdr->e_shnum; i++) {
+		shdr = elf_section(i);
+		if ((strtab->sh_offset + shdr->sh_name >= elf_size) ||
+		    (strcmp((const char *)elf + strtab->sh_offset +
+			    shdr->sh_name, BINARY_LOG_FMT_SECTION) != 0))
+			continue;
+		if (shdr->sh_offset + shdr->sh_size > elf_size)
+			break;
+		fmt_section = (const char *)elf + shdr->sh_offset;
+		fmt_section_size = shdr->sh_size;
+		return;
+	}
+
+	fprintf(stderr, "No %s section in the ELF file, was BL31 built with "
+		"BINARY_LOG=1?\n", BINARY_LOG_FMT_SECTION);
+	exit(1);
+}
+
+/*
+ * Return the string at address 'addr' in the loaded image, or NULL if it isn't
+ * part of the initialised sections of the ELF file.
+ */
+static const char *elf_string(uint64_t addr)
+{
+	const Elf64_Ehdr *ehdr = (const Elf64_Ehdr *)elf;
+	const Elf64_Shdr *shdr;
+	unsigned int i;
+
+	for (i = 0; i < ehdr->e_shnum; i++) {
+		shdr = elf_section(i);
+		if (((shdr->sh_flags & SHF_ALLOC) == 0) ||
+		    (shdr->sh_type != SHT_PROGBITS) ||
+		    (addr < shdr->sh_addr) ||
+		    (addr >= shdr->sh_addr + shdr->sh_size) ||
+		    (shdr->sh_offset + shdr->sh_size > elf_size))
+			continue;
+		/* The file buffer is NUL terminated */
+		return (const char *)elf + shdr->sh_offset +
+			(addr - shdr->sh_addr);
+	}
+
+	return NULL;
+}
+
+/* Print a message the way tf_vprintf() would have */
+static void print_message(const char *fmt, unsigned int nargs,
+			  const uint64_t *args)
+{
+	unsigned int arg = 0, l_count;
+	char spec[16], *p;
+	const char *str;
+	uint64_t val;
+
+	while (*fmt != '\0') {
+		if (*fmt != '%') {
+			putchar(*fmt++);
+			continue;
+		}
+
+		p = spec;
+		*p++ = *fmt++;
+		l_count = 0;
+		while ((*fmt == '0') ||
+		       ((*fmt >= '1') && (*fmt <= '9') && (p > spec + 1))) {
+			if (p < spec + 8)
+				*p++ = *fmt;
+			fmt++;
+		}
+		while ((*fmt == 'l') || (*fmt == 'z')) {
+			l_count = (*fmt == 'z') ? 2 : l_count + 1;
+			fmt++;
+		}
+
+		if (arg >= nargs) {
+			printf("<missing argument>");
+			return;
+		}
+		val = args[arg++];
+
+		switch (*fmt) {
+		case 'd':
+		case 'i':
+			strcpy(p, "lld");
+			printf(spec, (l_count != 0) ? (long long)val :
+			       (long long)(int32_t)val);
+			break;
+		case 'u':
+		case 'x':
+			p[0] = 'l';
+			p[1] = 'l';
+			p[2] = *fmt;
+			p[3] = '\0';
+			printf(spec, (l_count != 0) ? (unsigned long long)val :
+			       (unsigned long long)(uint32_t)val);
+			break;
+		case 'p':
+			if (val != 0)
+				printf("0x");
+			strcpy(p, "llx");
+			printf(spec, (unsigned long long)val);
+			break;
+		case 's':
+			str = elf_string(val);
+			if (str != NULL)
+				printf("%s", str);
+			else
+				printf("<string at 0x%llx>",
+				       (unsigned long long)val);
+			break;
+		default:
+			/* tf_vprintf() stops on unsupported specifiers */
+			return;
+		}
+		fmt++;
+	}
+}
+
+static int compare_messages(const void *a, const void *b)
+{
+	const message_t *ma = a, *mb = b;
+
+	if (ma->record->timestamp < mb->record->timestamp)
+		return -1;
+	if (ma->record->timestamp > mb->record->timestamp)
+		return 1;
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	const binary_log_header_t *header = NULL;
+	const binary_log_ring_t *ring;
+	const binary_log_record_t *record;
+	const char *elf_path = NULL, *dump_path = NULL;
+	uint8_t *dump;
+	size_t dump_size, ring_size, off;
+	message_t *messages;
+	unsigned int cpu, level, nargs, count = 0;
+	uint64_t seq, fmt_off, i;
+	int opt, timestamps = 0;
+
+	while ((opt = getopt(argc, argv, "e:d:t")) != -1) {
+		switch (opt) {
+		case 'e':
+			elf_path = optarg;
+			break;
+		case 'd':
+			dump_path = optarg;
+			break;
+		case 't':
+			timestamps = 1;
+			break;
+		default:
+			usage();
+		}
+	}
+	if ((elf_path == NULL) || (dump_path == NULL))
+		usage();
+
+	elf = read_file(elf_path, &elf_size);
+	elf_init();
+	dump = read_file(dump_path, &dump_size);
+
+	/* The log is 64-bit aligned, look for its header */
+	for (off = 0; off + sizeof(*header) <= dump_size;
+	     off += sizeof(uint64_t)) {
+		header = (const binary_log_header_t *)(dump + off);
+		if ((header->magic == BINARY_LOG_MAGIC) &&
+		    (header->version == BINARY_LOG_VERSION))
+			break;
+		header = NULL;
+	}
+	if (header == NULL) {
+		fprintf(stderr, "No binary log found in %s\n", dump_path);
+		return 1;
+	}
+
+	ring_size = sizeof(binary_log_ring_t) +
+		    (header->records * sizeof(binary_log_record_t));
+	if ((header->records == 0) || (header->cpu_count == 0) ||
+	    (off + sizeof(*header) + (header->cpu_count * ring_size) >
+	     dump_size)) {
+		fprintf(stderr, "The binary log is truncated\n");
+		return 1;
+	}
+
+	messages = calloc((size_t)header->cpu_count * header->records,
+			  sizeof(message_t));
+	if (messages == NULL) {
+		fprintf(stderr, "Failed to allocate the messages\n");
+		return 1;
+	}
+
+	for (cpu = 0; cpu < header->cpu_count; cpu++) {
+		ring = (const binary_log_ring_t *)(dump + off +
+			sizeof(*header) + (cpu * ring_size));
+		seq = ring->seq;
+		i = (seq > header->records) ? seq - header->records : 0;
+		for (; i < seq; i++) {
+			messages[count].cpu = cpu;
+			messages[count].record =
+				&ring->record[i % header->records];
+			count++;
+		}
+	}
+
+	qsort(messages, count, sizeof(message_t), compare_messages);
+
+	for (i = 0; i < count; i++) {
+		record = messages[i].record;
+		fmt_off = (record->info >> BINARY_LOG_FMT_SHIFT) &
+			  BINARY_LOG_FMT_MASK;
+		level = (record->info >> BINARY_LOG_LEVEL_SHIFT) &
+			BINARY_LOG_LEVEL_MASK;
+		nargs = (record->info >> BINARY_LOG_NARGS_SHIFT) &
+			BINARY_LOG_NARGS_MASK;
+
+		if (timestamps)
+			printf("[%016llx] ",
+			       (unsigned long long)record->timestamp);
+		printf("cpu%u: ", messages[i].cpu);
+		if (((level % 10) == 0) && ((level / 10) >= 1) &&
+		    ((level / 10) <= 5))
+			printf("%s", level_prefix[level / 10]);
+
+		if ((fmt_off >= fmt_section_size) ||
+		    (nargs > BINARY_LOG_MAX_ARGS)) {
+			printf("<corrupted record>\n");
+			continue;
+		}
+		print_message(fmt_section + fmt_off, nargs, record->args);
+	}
+
+	free(messages);
+	free(dump);
+	free(elf);
+
+	return 0;
+}